@@ -1,6 +1,9 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdint.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "forth_fast.h"
 
 #define WARMUP 100000
@@ -31,24 +34,26 @@ static void bench(const char* name, forth_t* vm, const char* code, uint32_t iter
 }
 
 static double bench_pure(forth_t* vm, const uint8_t* code, size_t len, const char* name) {
-    addr_t start = vm->here;
+    forth_image_t* img = &vm->image;
+    forth_ctx_t* ctx = &vm->ctx;
+    addr_t start = img->here;
     for (size_t i = 0; i < len; i++) {
-        vm->dict[vm->here++] = code[i];
+        img->dict[img->here++] = code[i];
     }
     
     for (int i = 0; i < WARMUP; i++) {
-        vm->sp = 0;
-        vm->rp = 0;
-        execute(vm, start);
+        ctx->sp = 0;
+        ctx->rp = 0;
+        execute(img, ctx, start);
     }
     
     struct timespec begin, end;
     clock_gettime(CLOCK_MONOTONIC, &begin);
     
     for (int i = 0; i < PURE_ITERATIONS; i++) {
-        vm->sp = 0;
-        vm->rp = 0;
-        execute(vm, start);
+        ctx->sp = 0;
+        ctx->rp = 0;
+        execute(img, ctx, start);
     }
     
     clock_gettime(CLOCK_MONOTONIC, &end);
@@ -61,6 +66,873 @@ static double bench_pure(forth_t* vm, const uint8_t* code, size_t len, const cha
     return ops_per_sec;
 }
 
+// Shared image scaling: N threads, each with its own context, one image
+#define SHARED_ITERATIONS 200000
+
+typedef struct {
+    forth_image_t* img;
+    addr_t start;
+} shared_job_t;
+
+static void* shared_worker(void* arg) {
+    shared_job_t* job = arg;
+    forth_ctx_t ctx;
+    init_ctx(&ctx);
+    for (int i = 0; i < SHARED_ITERATIONS; i++) {
+        ctx.sp = 0;
+        ctx.rp = 0;
+        execute(job->img, &ctx, job->start);
+    }
+    free_ctx(&ctx);
+    return NULL;
+}
+
+static void bench_shared_image(forth_t* vm, const char* word, cell_t arg) {
+    forth_image_t* img = &vm->image;
+    word_t* w = find_word(img, word);
+    if (!w) return;
+    
+    // Entry stub: LIT arg CALL word DROP EXIT
+    shared_job_t job = { img, img->here };
+    emit_byte(img, OP_LIT);
+    emit_cell(img, arg);
+    emit_byte(img, OP_CALL);
+    emit_addr(img, w->addr);
+    emit_byte(img, OP_DROP);
+    emit_byte(img, OP_EXIT);
+    
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    if (ncpu > 64) ncpu = 64;
+    
+    double base_rate = 0;
+    for (long n = 1; ; n = n * 2 < ncpu ? n * 2 : ncpu) {
+        pthread_t threads[64];
+        double t0 = now_sec();
+        for (long t = 0; t < n; t++) {
+            pthread_create(&threads[t], NULL, shared_worker, &job);
+        }
+        for (long t = 0; t < n; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        double elapsed = now_sec() - t0;
+        double rate = (double)n * SHARED_ITERATIONS / elapsed;
+        if (n == 1) base_rate = rate;
+        printf("%2ld thread(s) %-19s %8.2f M calls/sec  (x%.2f)\n",
+               n, "", rate / 1e6, rate / base_rate);
+        if (n == ncpu) break;
+    }
+}
+
+// Batch evaluation: data-dependent per-item cost (Collatz step counts)
+#define BATCH_ITEMS 100000
+
+static void bench_batch(forth_t* vm) {
+    word_t* w = find_word(&vm->image, "COLLATZ");
+    if (!w) return;
+    cell_t* args = malloc(BATCH_ITEMS * sizeof(cell_t));
+    cell_t* seq = malloc(BATCH_ITEMS * sizeof(cell_t));
+    cell_t* par = malloc(BATCH_ITEMS * sizeof(cell_t));
+    if (!args || !seq || !par) return;
+    for (int i = 0; i < BATCH_ITEMS; i++) {
+        args[i] = i + 1;
+    }
+    
+    double t0 = now_sec();
+    for (int i = 0; i < BATCH_ITEMS; i++) {
+        vm->ctx.sp = 0;
+        vm->ctx.rp = 0;
+        PUSH(&vm->ctx, args[i]);
+        execute(&vm->image, &vm->ctx, w->addr);
+        seq[i] = POP(&vm->ctx);
+    }
+    double elapsed = now_sec() - t0;
+    printf("%-30s %8.2f M items/sec\n", "Sequential (1 context)", BATCH_ITEMS / elapsed / 1e6);
+    
+    forth_pool_t pool;
+    if (init_pool(&pool, 0)) {
+        t0 = now_sec();
+        uint32_t failed = execute_batch(&pool, &vm->image, w->addr, args, 1, par, 1,
+                                        BATCH_ITEMS, NULL);
+        elapsed = now_sec() - t0;
+        char label[64];
+        snprintf(label, sizeof(label), "Batch (%d workers)", pool.nthreads);
+        printf("%-30s %8.2f M items/sec  (%s)\n", label, BATCH_ITEMS / elapsed / 1e6,
+               failed ? "ITEMS FAILED" :
+               memcmp(seq, par, BATCH_ITEMS * sizeof(cell_t)) == 0 ? "results match" : "MISMATCH");
+        free_pool(&pool);
+    }
+    free(args);
+    free(seq);
+    free(par);
+}
+
+// Task switch cost: main and one background task PAUSE back and forth
+#define SWITCH_ROUNDS 10000000
+
+static void bench_task_switch(forth_t* vm) {
+    interpret_line(vm, "TASK PINGER");
+    interpret_line(vm, ": PING BEGIN PAUSE AGAIN ;");
+    interpret_line(vm, "' PING PINGER ACTIVATE");
+    interpret_line(vm, ": SWITCHES 0 DO PAUSE LOOP ;");
+    interpret_line(vm, ": LOOPS 0 DO LOOP ;");
+    
+    char line[64];
+    snprintf(line, sizeof(line), "%d LOOPS", SWITCH_ROUNDS);
+    double t0 = now_sec();
+    interpret_line(vm, line);
+    double loop_time = now_sec() - t0;
+    
+    snprintf(line, sizeof(line), "%d SWITCHES", SWITCH_ROUNDS);
+    t0 = now_sec();
+    interpret_line(vm, line);
+    double elapsed = now_sec() - t0;
+    
+    // Each round is two switches: main -> PINGER -> main
+    double ns = (elapsed - loop_time) * 1e9 / (2.0 * SWITCH_ROUNDS);
+    printf("%-30s %8.2f ns/switch  (%6.2f ns/round incl. loop)\n",
+           "PAUSE (2 tasks)", ns, elapsed * 1e9 / SWITCH_ROUNDS);
+}
+
+// PAR-DO vs DO over the same range, on a pool with one worker per CPU
+static void bench_par_do(forth_t* vm) {
+    interpret_line(vm, ": PSUM 0 SWAP 0 PAR-DO I + PAR-LOOP + ;");
+    forth_pool_t pool;
+    if (!init_pool(&pool, 0)) return;
+    
+    const char* lines[] = { "10000000 SUM DROP", "10000000 PSUM DROP" };
+    const char* names[] = { "SUM (DO/LOOP, 10M)", "PSUM (PAR-DO, 10M)" };
+    for (int i = 0; i < 2; i++) {
+        vm->ctx.pool = i ? &pool : NULL;
+        double t0 = now_sec();
+        interpret_line(vm, lines[i]);
+        double elapsed = now_sec() - t0;
+        printf("%-30s %8.2f M iter/sec  (%d worker%s)\n", names[i], 10.0 / elapsed,
+               i ? pool.nthreads : 1, i && pool.nthreads > 1 ? "s" : "");
+    }
+    
+    // Stepped with a small budget: each step carries on where the slices
+    // stopped, so the loop finishes and its body runs once per index
+    interpret_line(vm, "VARIABLE HITS");
+    interpret_line(vm, ": PS 0 5000 0 PAR-DO 1 HITS ATOMIC+! I + PAR-LOOP + ;");
+    forth_ctx_t* ctx = &vm->ctx;
+    word_t* w = find_word(&vm->image, "PS");
+    for (int i = 0; w && i < 2; i++) {
+        ctx->pool = i ? &pool : NULL;
+        interpret_line(vm, "0 HITS !");
+        ctx->sp = 0;
+        step_start(ctx, w->addr);
+        long steps = 0;
+        int status;
+        do {
+            status = step(&vm->image, ctx, 256);
+            steps++;
+        } while (status == FF_OUT_OF_FUEL && steps < 100000);
+        ctx->fuel = FF_FUEL_UNLIMITED;
+        int correct = status == FF_OK && ctx->sp == 1 && ctx->ds[0] == 12497500;
+        interpret_line(vm, "HITS @");
+        correct = correct && ctx->sp == 2 && ctx->ds[1] == 5000;
+        printf("%-30s %8ld steps%s\n", i ? "PAR-DO 5000, stepped, pool" : "PAR-DO 5000, stepped",
+               steps, correct ? "" : "  WRONG RESULT");
+        ctx->sp = 0;
+    }
+    vm->ctx.pool = NULL;
+    free_pool(&pool);
+}
+
+// Channels: host-thread throughput and round-trip latency, plus two
+// Forth tasks passing cells through a channel inside one VM
+#define CHANNEL_ITEMS 5000000
+#define PINGPONG_ROUNDS 200000
+
+static forth_channel_t ch_a, ch_b;
+
+static void* channel_producer(void* arg) {
+    (void)arg;
+    for (cell_t i = 0; i < CHANNEL_ITEMS; i++) {
+        channel_send(&ch_a, i);
+    }
+    return NULL;
+}
+
+static void* channel_echo(void* arg) {
+    (void)arg;
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        channel_send(&ch_b, channel_recv(&ch_a));
+    }
+    return NULL;
+}
+
+static void bench_channels(forth_t* vm) {
+    if (!init_channel(&ch_a, 1024) || !init_channel(&ch_b, 1024)) return;
+    
+    pthread_t t;
+    double t0 = now_sec();
+    pthread_create(&t, NULL, channel_producer, NULL);
+    int64_t sum = 0;
+    for (int i = 0; i < CHANNEL_ITEMS; i++) {
+        sum += channel_recv(&ch_a);
+    }
+    pthread_join(t, NULL);
+    double elapsed = now_sec() - t0;
+    printf("%-30s %8.2f M cells/sec\n", "Host SPSC throughput", CHANNEL_ITEMS / elapsed / 1e6);
+    
+    t0 = now_sec();
+    pthread_create(&t, NULL, channel_echo, NULL);
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        channel_send(&ch_a, i);
+        sum += channel_recv(&ch_b);
+    }
+    pthread_join(t, NULL);
+    elapsed = now_sec() - t0;
+    printf("%-30s %8.2f ns/hop\n", "Host ping-pong latency", elapsed * 1e9 / (2.0 * PINGPONG_ROUNDS));
+    
+    interpret_line(vm, "64 CHANNEL PIPE");
+    interpret_line(vm, "TASK FEEDER");
+    char line[64];
+    snprintf(line, sizeof(line), ": FEED %d 0 DO I PIPE SEND LOOP ;", CHANNEL_ITEMS);
+    interpret_line(vm, line);
+    interpret_line(vm, ": DRAIN 0 SWAP 0 DO PIPE RECV + LOOP ;");
+    interpret_line(vm, "' FEED FEEDER ACTIVATE");
+    snprintf(line, sizeof(line), "%d DRAIN DROP", CHANNEL_ITEMS);
+    t0 = now_sec();
+    interpret_line(vm, line);
+    elapsed = now_sec() - t0;
+    printf("%-30s %8.2f M cells/sec\n", "Forth tasks SEND/RECV", CHANNEL_ITEMS / elapsed / 1e6);
+    
+    (void)sum;
+    free_channel(&ch_a);
+    free_channel(&ch_b);
+}
+
+// Bounded execution: the same loop unbounded and in fuel slices.
+// Build with -DFF_NO_SAFEPOINTS to compare against an engine without
+// safepoint checks at all.
+#define FUEL_SLICE 10000
+
+static void bench_fuel(forth_t* vm) {
+    forth_image_t* img = &vm->image;
+    forth_ctx_t* ctx = &vm->ctx;
+    word_t* w = find_word(img, "SUM");
+    if (!w) return;
+    
+    for (int sliced = 0; sliced < 2; sliced++) {
+        ctx->sp = 0;
+        ctx->rp = 0;
+        PUSH(ctx, 10000000);
+        ctx->fuel = sliced ? FUEL_SLICE : FF_FUEL_UNLIMITED;
+        long slices = 1;
+        double t0 = now_sec();
+        int status = execute(img, ctx, w->addr);
+        while (status == FF_OUT_OF_FUEL) {
+            ctx->fuel = FUEL_SLICE;
+            status = resume(img, ctx);
+            slices++;
+        }
+        double elapsed = now_sec() - t0;
+        char label[64];
+        if (sliced) {
+            snprintf(label, sizeof(label), "SUM 10M, %ld fuel slices", slices);
+        } else {
+            snprintf(label, sizeof(label), "SUM 10M, unbounded");
+        }
+        printf("%-30s %8.2f M iter/sec\n", label, 10.0 / elapsed);
+    }
+    ctx->sp = 0;
+    ctx->fuel = FF_FUEL_UNLIMITED;
+}
+
+// Many computations interleaved on one thread with the step API: each
+// tick steps every unfinished context by STEP_BUDGET safepoints.
+#define STEP_CONTEXTS 1000
+#define STEP_BUDGET 256
+
+static void bench_step(forth_t* vm) {
+    forth_image_t* img = &vm->image;
+    word_t* w = find_word(img, "SUM");
+    forth_ctx_t* ctxs = malloc(sizeof(forth_ctx_t) * STEP_CONTEXTS);
+    char* done = calloc(STEP_CONTEXTS, 1);
+    if (!w || !ctxs || !done) {
+        free(ctxs);
+        free(done);
+        return;
+    }
+    
+    for (int i = 0; i < STEP_CONTEXTS; i++) {
+        init_ctx(&ctxs[i]);
+        PUSH(&ctxs[i], 10000);
+        step_start(&ctxs[i], w->addr);
+    }
+    int running = STEP_CONTEXTS;
+    long steps = 0;
+    double worst = 0;
+    double t0 = now_sec();
+    while (running > 0) {
+        for (int i = 0; i < STEP_CONTEXTS; i++) {
+            forth_ctx_t* ctx = &ctxs[i];
+            if (done[i]) continue;
+            double t1 = now_sec();
+            int status = step(img, ctx, STEP_BUDGET);
+            double t = now_sec() - t1;
+            if (t > worst) worst = t;
+            steps++;
+            if (status != FF_OUT_OF_FUEL) {
+                done[i] = 1;
+                running--;
+            }
+        }
+    }
+    double elapsed = now_sec() - t0;
+    int correct = 1;
+    for (int i = 0; i < STEP_CONTEXTS; i++) {
+        if (ctxs[i].sp != 1 || ctxs[i].ds[0] != 49995000) correct = 0;
+    }
+    printf("%-30s %8.2f M iter/sec  (%ld steps)\n", "1000 x SUM 10000, stepped",
+           (double)STEP_CONTEXTS * 10000 / elapsed / 1e6, steps);
+    printf("%-30s %8.2f us  (longest %.2f us)%s\n", "  per step", elapsed / steps * 1e6,
+           worst * 1e6, correct ? "" : "  WRONG RESULT");
+    for (int i = 0; i < STEP_CONTEXTS; i++) free_ctx(&ctxs[i]);
+    free(ctxs);
+    free(done);
+}
+
+// M:N scheduler: 100k resident tenant fibers that do a little work per
+// event and park on KEY, then fairness among compute-bound fibers that
+// spin until the host delivers a key.
+#define SCHED_FIBERS 100000
+#define SCHED_SPINNERS 1000
+
+typedef struct {
+    forth_sched_t* sched;
+    forth_fiber_t** fibers;
+    int count;
+} sched_stopper_t;
+
+static void* sched_stop_later(void* p) {
+    sched_stopper_t* st = p;
+    struct timespec delay = { 0, 300000000 };
+    nanosleep(&delay, NULL);
+    for (int i = 0; i < st->count; i++) sched_deliver(st->sched, st->fibers[i], ' ');
+    return NULL;
+}
+
+static void bench_sched(forth_t* vm) {
+    forth_image_t* img = &vm->image;
+    word_t* tenant = find_word(img, "TENANT");
+    word_t* spin = find_word(img, "SPIN");
+    forth_fiber_t** fibers = malloc(sizeof(forth_fiber_t*) * SCHED_FIBERS);
+    forth_pool_t pool;
+    forth_sched_t sched;
+    if (!tenant || !spin || !fibers || !init_pool(&pool, 0)) return;
+    init_sched(&sched, img);
+    
+    double t0 = now_sec();
+    for (int i = 0; i < SCHED_FIBERS; i++) {
+        fibers[i] = sched_spawn(&sched, tenant->addr, NULL, 0);
+    }
+    sched_run(&sched, &pool);
+    double elapsed = now_sec() - t0;
+    size_t fiber_bytes = sizeof(forth_fiber_t) +
+        line_round(line_round(FF_STACK_DEPTH * sizeof(cell_t)) + FF_RET_DEPTH * sizeof(cell_t));
+    printf("%-30s %8.2f ms  (%zu bytes/fiber, %.0f MB)\n", "Spawn 100k, run until parked",
+           elapsed * 1e3, fiber_bytes, SCHED_FIBERS * fiber_bytes / 1e6);
+    
+    // Events: a key for every 10th fiber, ten rounds
+    int events = 0;
+    t0 = now_sec();
+    for (int round = 0; round < 10; round++) {
+        for (int i = round; i < SCHED_FIBERS; i += 10) {
+            events += sched_deliver(&sched, fibers[i], 'x');
+        }
+        sched_run(&sched, &pool);
+    }
+    elapsed = now_sec() - t0;
+    printf("%-30s %8.2f M events/sec  (%.0f ns/event)\n", "Wake, run, park again",
+           events / elapsed / 1e6, elapsed / events * 1e9);
+    for (int i = 0; i < SCHED_FIBERS; i++) free_fiber(fibers[i]);
+    
+    // Fairness: spinners count until stopped; compare their counts
+    for (int i = 0; i < SCHED_SPINNERS; i++) {
+        fibers[i] = sched_spawn(&sched, spin->addr, NULL, 0);
+    }
+    sched_stopper_t stopper = { &sched, fibers, SCHED_SPINNERS };
+    pthread_t stop_thread;
+    pthread_create(&stop_thread, NULL, sched_stop_later, &stopper);
+    sched_run(&sched, &pool);
+    pthread_join(stop_thread, NULL);
+    cell_t lo = FF_CELL_MAX, hi = 0;
+    double total = 0;
+    for (int i = 0; i < SCHED_SPINNERS; i++) {
+        cell_t n = fibers[i]->ctx.sp > 0 ? fibers[i]->ctx.ds[0] : 0;
+        if (n < lo) lo = n;
+        if (n > hi) hi = n;
+        total += n;
+        free_fiber(fibers[i]);
+    }
+    printf("%-30s %8.0f iter/fiber avg  (min %d, max %d)\n", "1000 spinners, 300 ms",
+           total / SCHED_SPINNERS, (int)lo, (int)hi);
+    
+    free_sched(&sched);
+    free_pool(&pool);
+    free(fibers);
+}
+
+// RCU-published image: reader threads run LOOP100 on whatever image is
+// published while the main thread keeps publishing updates
+#define RCU_READERS 2
+#define RCU_UPDATES 20000
+
+typedef struct {
+    forth_rcu_t* rcu;
+    _Atomic int* stop;
+    long calls;
+} rcu_reader_t;
+
+static void* rcu_reader(void* p) {
+    rcu_reader_t* r = p;
+    int id = rcu_register(r->rcu);
+    forth_ctx_t* ctx = malloc(sizeof(*ctx));
+    init_ctx(ctx);
+    while (!atomic_load_explicit(r->stop, memory_order_relaxed)) {
+        forth_image_t* img = rcu_read_lock(r->rcu, id);
+        word_t* w = find_word(img, "LOOP100");
+        for (int i = 0; i < 100; i++) execute(img, ctx, w->addr);
+        rcu_read_unlock(r->rcu, id);
+        r->calls += 100;
+    }
+    rcu_unregister(r->rcu, id);
+    free_ctx(ctx);
+    free(ctx);
+    return NULL;
+}
+
+static void bench_rcu(forth_t* vm) {
+    interpret_line(vm, "VARIABLE GEN");
+    forth_rcu_t* rcu = malloc(sizeof(*rcu));
+    if (!rcu || !init_rcu(rcu, vm)) return;
+    
+    for (int updating = 0; updating < 2; updating++) {
+        _Atomic int stop = 0;
+        rcu_reader_t readers[RCU_READERS];
+        pthread_t threads[RCU_READERS];
+        for (int i = 0; i < RCU_READERS; i++) {
+            readers[i] = (rcu_reader_t){ rcu, &stop, 0 };
+            pthread_create(&threads[i], NULL, rcu_reader, &readers[i]);
+        }
+        double t0 = now_sec();
+        if (updating) {
+            for (int i = 0; i < RCU_UPDATES; i++) {
+                char src[32];
+                snprintf(src, sizeof(src), "%d GEN !", i);
+                rcu_update(rcu, src);
+            }
+        } else {
+            struct timespec delay = { 0, 200000000 };
+            nanosleep(&delay, NULL);
+        }
+        double elapsed = now_sec() - t0;
+        atomic_store(&stop, 1);
+        long calls = 0;
+        for (int i = 0; i < RCU_READERS; i++) {
+            pthread_join(threads[i], NULL);
+            calls += readers[i].calls;
+        }
+        printf("%-30s %8.2f M calls/sec\n", updating ? "Readers, writer publishing" : "Readers, no updates",
+               calls / elapsed / 1e6);
+        if (updating) {
+            printf("%-30s %8.2f us/update  (%ld reclaimed)\n", "  publish (copy + swap)",
+                   elapsed / RCU_UPDATES * 1e6, rcu->reclaimed);
+        }
+    }
+    free_rcu(rcu);
+    free(rcu);
+}
+
+// Per-request VM setup: a fresh init_forth() against checkout/release
+// from a pool. The request compiles a word and stores into the
+// dictionary, so release has dirty pages and word slots to restore.
+#define POOL_REQUESTS 200000
+
+static void bench_vm_pool(forth_t* vm) {
+    const char* request = ": REQ 7 HITS +! HITS @ ; REQ DROP";
+    interpret_line(vm, "VARIABLE HITS");
+    
+    forth_t* fresh = malloc(sizeof(*fresh));
+    double t0 = now_sec();
+    for (int i = 0; i < POOL_REQUESTS / 10; i++) {
+        init_forth(fresh);
+        interpret_line(fresh, "VARIABLE HITS");
+        interpret_line(fresh, request);
+        free_forth(fresh);
+    }
+    double elapsed = now_sec() - t0;
+    printf("%-30s %8.2f us/request\n", "init_forth per request", elapsed / (POOL_REQUESTS / 10) * 1e6);
+    free(fresh);
+    
+    forth_vm_pool_t pool;
+    if (!init_vm_pool(&pool, vm, 4)) return;
+    double checkout = 0;
+    t0 = now_sec();
+    for (int i = 0; i < POOL_REQUESTS; i++) {
+        double t1 = now_sec();
+        forth_t* v = vm_pool_acquire(&pool);
+        double t2 = now_sec();
+        interpret_line(v, request);
+        double t3 = now_sec();
+        vm_pool_release(&pool, v);
+        checkout += (t2 - t1) + (now_sec() - t3);
+    }
+    elapsed = now_sec() - t0;
+    printf("%-30s %8.2f us/request\n", "VM pool per request", elapsed / POOL_REQUESTS * 1e6);
+    printf("%-30s %8.0f ns\n", "  acquire + reset/release", checkout / POOL_REQUESTS * 1e9);
+    
+    forth_t* v = vm_pool_acquire(&pool);
+    word_t* w = find_word(&v->image, "HITS");
+    int clean = w && v->image.word_count == vm->image.word_count &&
+                memcmp(v->image.dict, vm->image.dict, (size_t)vm->image.dict_size) == 0;
+    printf("%-30s %s\n", "  state after reset", clean ? "matches base" : "DIFFERS");
+    
+    // A request's heap data must not reach the next one on the same VM
+    interpret_line(v, "16 ALLOCATE DROP 424242 SWAP !");
+    vm_pool_release(&pool, v);
+    v = vm_pool_acquire(&pool);
+    interpret_line(v, "16 ALLOCATE DROP @");
+    int cleared = v->ctx.sp == 1 && v->ctx.ds[0] == 0;
+    printf("%-30s %s\n", "  heap after reset", cleared ? "cleared" : "LEAKS DATA");
+    vm_pool_release(&pool, v);
+    free_vm_pool(&pool);
+}
+
+// Profile-driven relayout: hot words defined between cold words with
+// long ." strings and VARIABLEs, timed before and after RELAYOUT
+static double time_word(forth_t* vm, addr_t xt, int runs) {
+    double t0 = now_sec();
+    for (int i = 0; i < runs; i++) {
+        vm->ctx.sp = 0;
+        execute(&vm->image, &vm->ctx, xt);
+    }
+    return (now_sec() - t0) / runs;
+}
+
+static void bench_relayout(void) {
+    forth_t* vm = malloc(sizeof(*vm));
+    if (!vm || !init_forth(vm)) {
+        free(vm);
+        return;
+    }
+    char line[256];
+    for (int k = 0; k < 12; k++) {
+        snprintf(line, sizeof(line), ": H%d ( n -- n' ) DUP %d XOR + ;", k, k + 1);
+        interpret_line(vm, line);
+        snprintf(line, sizeof(line), ": C%d .\" cold path %d: rarely printed, but it sits "
+                 "right between two hot words\" CR ;", k, k);
+        interpret_line(vm, line);
+        snprintf(line, sizeof(line), "VARIABLE V%d", k);
+        interpret_line(vm, line);
+    }
+    interpret_line(vm, ": WORK 0 100 0 DO H0 H1 H2 H3 H4 H5 H6 H7 H8 H9 H10 H11 LOOP DROP ;");
+    
+    interpret_line(vm, "PROFILE");
+    interpret_line(vm, "WORK");
+    time_word(vm, find_word(&vm->image, "WORK")->addr, 1000);
+    double before = time_word(vm, find_word(&vm->image, "WORK")->addr, 20000);
+    printf("%-30s %8.2f us/run\n", "Definition order", before * 1e6);
+    interpret_line(vm, "RELAYOUT");
+    double after = time_word(vm, find_word(&vm->image, "WORK")->addr, 20000);
+    printf("%-30s %8.2f us/run\n", "Hot/cold relayout", after * 1e6);
+    free_forth(vm);
+    free(vm);
+}
+
+// Loop over 256 cells in pure bytecode: fill with !, sum with @ or
+// bump with +!, at a cell-aligned base or one byte off it
+static void bench_array(forth_t* vm, uint8_t op, int misalign, const char* name) {
+    forth_image_t* img = &vm->image;
+    forth_ctx_t* ctx = &vm->ctx;
+    addr_t start = img->here;
+    cell_t base = ((start + 64) & ~(cell_t)(sizeof(cell_t) - 1)) + misalign;
+    uint8_t* c = &img->dict[start];
+    int n = 0;
+    c[n++] = OP_LIT;
+    store_cell(&c[n], 256);
+    n += sizeof(cell_t);
+    c[n++] = OP_LIT;
+    store_cell(&c[n], 0);
+    n += sizeof(cell_t);
+    c[n++] = OP_DO;
+    addr_t body = start + n;
+    c[n++] = OP_I;
+    if (op != OP_LOAD) c[n++] = OP_DUP;     // Value to store: the index
+    c[n++] = OP_CELLS;
+    c[n++] = OP_LIT;
+    store_cell(&c[n], base);
+    n += sizeof(cell_t);
+    c[n++] = OP_ADD;
+    c[n++] = op;
+    if (op == OP_LOAD) c[n++] = OP_ADD;     // Into the sum below the loop
+    c[n++] = OP_LOOP;
+    c[n++] = body & 0xFF;
+    c[n++] = body >> 8;
+    c[n++] = OP_EXIT;
+    
+    const int runs = 100000;
+    for (int i = 0; i < runs / 10; i++) {
+        ctx->sp = ctx->rp = 0;
+        PUSH(ctx, 0);
+        execute(img, ctx, start);
+    }
+    double t0 = now_sec();
+    for (int i = 0; i < runs; i++) {
+        ctx->sp = ctx->rp = 0;
+        PUSH(ctx, 0);
+        execute(img, ctx, start);
+    }
+    double elapsed = now_sec() - t0;
+    printf("%-30s %8.2f ns/element\n", name, elapsed / runs / 256 * 1e9);
+}
+
+// Heap: an ALLOCATE/FREE pair in one size class, mixed sizes kept
+// live, and dropping them all with heap_reset()
+static void bench_heap(forth_t* vm) {
+    interpret_line(vm, ": CHURN ( n -- ) 0 DO 48 ALLOCATE DROP FREE DROP LOOP ;");
+    interpret_line(vm, ": FILL-HEAP ( n -- ) 0 DO I 255 AND 8 * ALLOCATE 2DROP LOOP ;");
+    addr_t churn = find_word(&vm->image, "CHURN")->addr;
+    addr_t fill = find_word(&vm->image, "FILL-HEAP")->addr;
+    const int n = 1000000, blocks = 10000;
+    
+    PUSH(&vm->ctx, n);
+    double t0 = now_sec();
+    execute(&vm->image, &vm->ctx, churn);
+    double elapsed = now_sec() - t0;
+    printf("%-30s %8.2f ns/pair\n", "ALLOCATE + FREE (48 bytes)", elapsed / n * 1e9);
+    
+    double alloc = 0, reset = 0;
+    for (int r = 0; r < 100; r++) {
+        PUSH(&vm->ctx, blocks);
+        t0 = now_sec();
+        execute(&vm->image, &vm->ctx, fill);
+        double t1 = now_sec();
+        heap_reset(vm->ctx.heap);
+        alloc += t1 - t0;
+        reset += now_sec() - t1;
+    }
+    printf("%-30s %8.2f ns/block  (heap_reset %.2f us for %d)\n", "ALLOCATE 0..2040 bytes, live",
+           alloc / (100.0 * blocks) * 1e9, reset / 100 * 1e6, blocks);
+}
+
+// Clearing and copying a 4000-byte heap buffer: a C! loop in Forth
+// against one ERASE or MOVE
+static void bench_bulk(forth_t* vm) {
+    interpret_line(vm, "4000 ALLOCATE DROP CONSTANT SRC 4000 ALLOCATE DROP CONSTANT DST");
+    interpret_line(vm, ": CLEAR-LOOP 4000 0 DO 0 DST I + C! LOOP ;");
+    interpret_line(vm, ": CLEAR-BULK DST 4000 ERASE ;");
+    interpret_line(vm, ": COPY-LOOP 4000 0 DO SRC I + C@ DST I + C! LOOP ;");
+    interpret_line(vm, ": COPY-BULK SRC DST 4000 MOVE ;");
+    static const char* names[] = { "CLEAR-LOOP", "CLEAR-BULK", "COPY-LOOP", "COPY-BULK" };
+    static const char* labels[] = { "Clear 4000 bytes, C! loop", "Clear 4000 bytes, ERASE",
+                                    "Copy 4000 bytes, C@ C! loop", "Copy 4000 bytes, MOVE" };
+    double loop = 0;
+    for (int k = 0; k < 4; k++) {
+        addr_t w = find_word(&vm->image, names[k])->addr;
+        int runs = k % 2 ? 200000 : 2000;
+        double t0 = now_sec();
+        for (int i = 0; i < runs; i++) {
+            vm->ctx.sp = vm->ctx.rp = 0;
+            execute(&vm->image, &vm->ctx, w);
+        }
+        double us = (now_sec() - t0) / runs * 1e6;
+        if (k % 2 == 0) {
+            loop = us;
+            printf("%-30s %8.2f us\n", labels[k], us);
+        } else {
+            printf("%-30s %8.2f us  (x%.0f)\n", labels[k], us, loop / us);
+        }
+    }
+}
+
+// 1000! (2568 digits): one decimal digit per byte with a 10 /MOD
+// carry loop in Forth, against BIG*N on cell limbs and one BIG>STR
+static void bench_bignum(forth_t* vm) {
+    interpret_line(vm, "4000 ALLOCATE DROP CONSTANT DIGITS VARIABLE TOP");
+    interpret_line(vm, ": *DIGITS ( n -- ) 0 TOP @ 1+ 0 DO OVER DIGITS I + C@ * + 10 /MOD "
+                       "SWAP DIGITS I + C! LOOP BEGIN ?DUP WHILE 10 /MOD SWAP 1 TOP +! "
+                       "DIGITS TOP @ + C! REPEAT DROP ;");
+    interpret_line(vm, ": FAC-DIGITS 1 DIGITS C! 0 TOP ! 1001 2 DO I *DIGITS LOOP ;");
+    interpret_line(vm, "302 CELLS ALLOCATE DROP CONSTANT BIGF 300 BIGF BIG-INIT");
+    interpret_line(vm, "4000 ALLOCATE DROP CONSTANT TEXT");
+    interpret_line(vm, ": FAC-BIG 1 BIGF BIG! 1001 2 DO BIGF I BIG*N DROP LOOP BIGF TEXT 4000 BIG>STR ;");
+    static const char* names[] = { "FAC-DIGITS", "FAC-BIG" };
+    static const char* labels[] = { "1000!, digit per byte", "1000!, BIG*N + BIG>STR" };
+    double loop = 0;
+    cell_t len = 0;
+    for (int k = 0; k < 2; k++) {
+        addr_t w = find_word(&vm->image, names[k])->addr;
+        int runs = k ? 2000 : 20;
+        double t0 = now_sec();
+        for (int i = 0; i < runs; i++) {
+            vm->ctx.sp = vm->ctx.rp = 0;
+            execute(&vm->image, &vm->ctx, w);
+        }
+        double us = (now_sec() - t0) / runs * 1e6;
+        if (k == 0) {
+            loop = us;
+            printf("%-30s %8.2f us\n", labels[k], us);
+        } else {
+            len = POP(&vm->ctx);
+            printf("%-30s %8.2f us  (x%.0f)\n", labels[k], us, loop / us);
+        }
+    }
+    
+    // Both must agree: the Forth buffer holds the digits in reverse
+    vm->ctx.sp = 0;
+    interpret_line(vm, "TOP @ 1+ DIGITS TEXT");
+    cell_t text = POP(&vm->ctx);
+    cell_t digits = POP(&vm->ctx);
+    cell_t n = POP(&vm->ctx);
+    const uint8_t* d = mem_at(&vm->image, &vm->ctx, digits, n);
+    const uint8_t* t = mem_at(&vm->image, &vm->ctx, text, n);
+    int same = d && t && n == len;
+    for (cell_t i = 0; same && i < n; i++) same = t[i] == '0' + d[n - 1 - i];
+    printf("%-30s %lld digits, %s\n", "  result", (long long)n, same ? "match" : "DIFFER");
+}
+
+// Proportional set size of the process (shared pages split between
+// their users), 0 if unknown
+static size_t pss_bytes(void) {
+    FILE* f = fopen("/proc/self/smaps_rollup", "r");
+    char line[128];
+    unsigned long kb = 0;
+    while (f && fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "Pss: %lu kB", &kb) == 1) break;
+    }
+    if (f) fclose(f);
+    return (size_t)kb * 1024;
+}
+
+// Children of a warmed-up VM with a large dictionary, each storing to
+// a variable: clone_vm copies the image, fork_vm maps a snapshot
+static void bench_fork(void) {
+    enum { CHILDREN = 1000 };
+    static const forth_sizes_t sizes = { FF_STACK_DEPTH, FF_RET_DEPTH, FF_DICT_MAX, 1024 };
+    forth_t* parent = malloc(sizeof(*parent));
+    forth_t* kids = malloc(sizeof(forth_t) * CHILDREN);
+    if (!parent || !kids || !init_forth_sized(parent, &sizes)) {
+        if (parent) free_forth(parent);
+        free(parent);
+        free(kids);
+        return;
+    }
+    char line[256];
+    for (int k = 0; k < 800; k++) {
+        snprintf(line, sizeof(line), ": W%d ( n -- n' ) DUP %d + SWAP %d * XOR DUP 2 / + "
+                 "%d MOD DUP 0< IF NEGATE THEN ;", k, k, k + 1, k + 7);
+        interpret_line(parent, line);
+    }
+    interpret_line(parent, "VARIABLE RESULT : TRY ( n -- ) W799 W3 RESULT ! ;");
+    addr_t try = find_word(&parent->image, "TRY")->addr;
+    interpret_line(parent, "RESULT");
+    cell_t result = POP(&parent->ctx);
+    printf("%-30s %8d bytes of code, %d words\n", "Parent", parent->image.here,
+           parent->image.word_count);
+    
+    for (int pass = 0; pass < 2; pass++) {
+        forth_snapshot_t snap;
+        size_t pss = pss_bytes();
+        double t0 = now_sec();
+        if (pass == 1 && !snapshot_vm(&snap, parent)) {
+            printf("snapshot failed\n");
+            free_snapshot(&snap);
+            break;
+        }
+        double t1 = now_sec();
+        int made = 0;
+        for (; made < CHILDREN; made++) {
+            forth_t* kid = &kids[made];
+            if (!(pass == 0 ? clone_vm(kid, parent) : fork_vm(kid, &snap))) {
+                free_forth(kid);
+                break;
+            }
+            PUSH(&kid->ctx, made);
+            execute(&kid->image, &kid->ctx, try);
+        }
+        double elapsed = now_sec() - t1;
+        size_t grown = pss_bytes() - pss;
+        // Each child kept its own result; the parent's runs now change
+        // only its own dictionary
+        int match = made == CHILDREN;
+        for (int i = 0; i < made; i++) {
+            PUSH(&parent->ctx, i);
+            execute(&parent->image, &parent->ctx, try);
+            cell_t expect, got;
+            memcpy(&expect, &parent->image.dict[result], sizeof(cell_t));
+            memcpy(&got, &kids[i].image.dict[result], sizeof(cell_t));
+            match &= got == expect;
+            free_forth(&kids[i]);
+        }
+        const char* verdict = match ? "results match" : "RESULTS DIFFER";
+        if (pass == 0) {
+            printf("%-30s %8.2f us/child  (%zu KB each, %s)\n", "clone_vm + run",
+                   elapsed / CHILDREN * 1e6, grown / CHILDREN / 1024, verdict);
+        } else {
+            printf("%-30s %8.2f us/child  (%zu KB each, snapshot %.1f us, %s)\n",
+                   "fork_vm + run", elapsed / CHILDREN * 1e6, grown / CHILDREN / 1024,
+                   (t1 - t0) * 1e6, verdict);
+            free_snapshot(&snap);
+        }
+    }
+    free_forth(parent);
+    free(parent);
+    free(kids);
+}
+
+// Scratch definitions thrown away with a marker, many more times than
+// the dictionary could hold them
+static void bench_marker(forth_t* vm) {
+    const int cycles = 100000;
+    addr_t here = vm->image.here;
+    int words = vm->image.word_count;
+    double t0 = now_sec();
+    for (int i = 0; i < cycles; i++) {
+        interpret_line(vm, "MARKER SCRATCH : T1 DUP * ; : T2 T1 T1 ; VARIABLE T3 SCRATCH");
+    }
+    double elapsed = now_sec() - t0;
+    int same = vm->image.here == here && vm->image.word_count == words;
+    printf("%-30s %8.2f us/cycle  (%d cycles, %s)\n", "MARKER, 3 definitions, forget",
+           elapsed / cycles * 1e6, cycles, same ? "space reclaimed" : "SPACE LEAKED");
+}
+
+// Memory per VM for a few size profiles, and what creating one costs
+static void bench_vm_sizes(void) {
+    static const struct {
+        const char* name;
+        forth_sizes_t sizes;
+    } profiles[] = {
+        { "Small (32/16 cells, 1K, 128)", { 32, 16, 1024, 128 } },
+        { "Default", { FF_STACK_DEPTH, FF_RET_DEPTH, FF_DICT_SIZE, FF_MAX_WORDS } },
+        { "Large (1K/512 cells, 64K, 1K)", { 1024, 512, FF_DICT_MAX, 1024 } },
+    };
+    forth_t* vm = malloc(sizeof(*vm));
+    if (!vm) return;
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        if (!init_forth_sized(vm, &profiles[i].sizes)) {
+            printf("%-30s failed\n", profiles[i].name);
+            free_forth(vm);
+            continue;
+        }
+        size_t bytes = forth_vm_bytes(vm);
+        free_forth(vm);
+        double t0 = now_sec();
+        for (int k = 0; k < 10000; k++) {
+            init_forth_sized(vm, &profiles[i].sizes);
+            free_forth(vm);
+        }
+        double elapsed = now_sec() - t0;
+        printf("%-30s %8zu bytes/VM  (create + free %.2f us)\n", profiles[i].name,
+               bytes, elapsed / 10000 * 1e6);
+    }
+    free(vm);
+}
+
 int main(void) {
     printf("Comprehensive Forth VM Benchmark\n");
     printf("================================\n\n");
@@ -79,6 +951,9 @@ int main(void) {
     interpret_line(&vm, ": LOOP10 10 0 DO LOOP ;");
     interpret_line(&vm, ": LOOP100 100 0 DO LOOP ;");
     interpret_line(&vm, ": LOOPI 10 0 DO I DROP LOOP ;");
+    interpret_line(&vm, ": TENANT 0 BEGIN 50 0 DO I + LOOP KEY DROP AGAIN ;");
+    interpret_line(&vm, ": SPIN 0 BEGIN 1+ KEY? UNTIL ;");
+    interpret_line(&vm, ": COLLATZ 0 SWAP BEGIN DUP 1 > WHILE DUP 2 MOD IF 3 * 1+ ELSE 2 / THEN SWAP 1+ SWAP REPEAT DROP ;");
     
     printf("Primitives (with parsing):\n");
     bench("Empty word (NOP)", &vm, "NOP", 10000000);
@@ -497,6 +1372,23 @@ int main(void) {
         };
         bench_pure(&vm, code, sizeof(code), "DIV + MOD");
     }
+    {
+        // One step of a wide-limb multiply: limb * k + carry, split
+        uint8_t code[] = {
+            OP_LIT, 0x39, 0x30, 0, 0x70,
+            OP_LIT, 0xE8, 0x03, 0, 0,
+            OP_UMSTAR,
+            OP_LIT, 7, 0, 0, 0,
+            OP_LIT, 0, 0, 0, 0,
+            OP_DPLUS,
+            OP_LIT, 0x00, 0xCA, 0x9A, 0x3B,
+            OP_UMSLASHMOD,
+            OP_DROP,
+            OP_DROP,
+            OP_EXIT
+        };
+        bench_pure(&vm, code, sizeof(code), "UM* D+ UM/MOD");
+    }
     
     printf("\nMemory Operations:\n");
     {
@@ -529,6 +1421,10 @@ int main(void) {
         };
         bench_pure(&vm, code, sizeof(code), "C@ and C!");
     }
+    bench_array(&vm, OP_STORE, 0, "Fill 256 cells (!)");
+    bench_array(&vm, OP_LOAD, 0, "Sum 256 cells (@)");
+    bench_array(&vm, OP_PLUSSTORE, 0, "Bump 256 cells (+!)");
+    bench_array(&vm, OP_LOAD, 1, "Sum 256 cells, unaligned");
     
     printf("\nControl Flow (pure bytecode):\n");
     {
@@ -560,6 +1456,57 @@ int main(void) {
         bench_pure(&vm, code, sizeof(code), "IF/ELSE/THEN (false)");
     }
     
+    printf("\nShared image, one context per thread (100 SUM):\n");
+    bench_shared_image(&vm, "SUM", 100);
+    
+    printf("\nBatch execution over a thread pool (COLLATZ):\n");
+    bench_batch(&vm);
+    
+    printf("\nParallel DO loop with + reduction:\n");
+    bench_par_do(&vm);
+    
+    printf("\nRCU-published image (LOOP100):\n");
+    bench_rcu(&vm);
+    
+    printf("\nM:N scheduler:\n");
+    bench_sched(&vm);
+    
+    printf("\nStep API (one thread):\n");
+    bench_step(&vm);
+    
+    printf("\nVM pool:\n");
+    bench_vm_pool(&vm);
+    
+    printf("\nVM size profiles:\n");
+    bench_vm_sizes();
+    
+    printf("\nCopy-on-write fork (1000 children of a 64 KB dictionary):\n");
+    bench_fork();
+    
+    printf("\nProfile-driven relayout (12 hot words among cold ones):\n");
+    bench_relayout();
+    
+    printf("\nMARKER (scratch definitions):\n");
+    bench_marker(&vm);
+    
+    printf("\nHeap (ALLOCATE/FREE):\n");
+    bench_heap(&vm);
+    
+    printf("\nBulk memory (MOVE/ERASE):\n");
+    bench_bulk(&vm);
+    
+    printf("\nBignum (1000!):\n");
+    bench_bignum(&vm);
+    
+    printf("\nBounded execution (fuel):\n");
+    bench_fuel(&vm);
+    
+    printf("\nCooperative tasks:\n");
+    bench_task_switch(&vm);
+    
+    printf("\nChannels:\n");
+    bench_channels(&vm);
+    
     printf("\n");
     printf("Summary:\n");
     printf("--------\n");
@@ -0,0 +1,177 @@
+// Load generator for forth_fast -s: closed-loop clients over a Unix socket
+// Usage: bench_server SOCKET [connections] [requests-per-connection] [request]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const char* path;
+    const char* request;
+    int requests;
+    double* latency;    // Seconds, one per request
+    int failed;
+    char first[256];    // First reply, for a sanity check
+} client_t;
+
+static int connect_to(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Read one reply: a header line with the output length, then the output
+static int read_reply(int fd, char* buf, size_t size, size_t* len) {
+    size_t n = 0;
+    char* nl = NULL;
+    while (!nl) {
+        if (n == size) return 0;
+        ssize_t r = read(fd, buf + n, size - n);
+        if (r <= 0) return 0;
+        n += (size_t)r;
+        nl = memchr(buf, '\n', n);
+    }
+    char status[16];
+    size_t outlen;
+    if (sscanf(buf, "%15s %zu", status, &outlen) != 2) return 0;
+    size_t total = (size_t)(nl + 1 - buf) + outlen;
+    while (n < total) {
+        if (n == size) return 0;
+        ssize_t r = read(fd, buf + n, size - n);
+        if (r <= 0) return 0;
+        n += (size_t)r;
+    }
+    *len = n;
+    return strcmp(status, "ok") == 0;
+}
+
+// Send one request on a fresh connection; 1 if the reply's status is
+// want. A receive timeout turns a hung worker into a failure.
+static int probe(const char* path, const char* request, const char* want) {
+    int fd = connect_to(path);
+    if (fd < 0) return 0;
+    struct timeval tv = { .tv_sec = 5 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    char line[1024], reply[8192], status[16] = "";
+    snprintf(line, sizeof(line), "%s\n", request);
+    size_t len = 0;
+    if (write(fd, line, strlen(line)) == (ssize_t)strlen(line)) {
+        read_reply(fd, reply, sizeof(reply) - 1, &len);
+        reply[len] = '\0';
+        if (len > 0) sscanf(reply, "%15s", status);
+    }
+    close(fd);
+    if (strcmp(status, want) != 0) {
+        fprintf(stderr, "Probe \"%s\": expected %s, got %s\n", request, want,
+                status[0] ? status : "no reply");
+        return 0;
+    }
+    return 1;
+}
+
+static void* client(void* arg) {
+    client_t* c = arg;
+    int fd = connect_to(c->path);
+    if (fd < 0) {
+        c->failed = c->requests;
+        return NULL;
+    }
+    char line[1024];
+    snprintf(line, sizeof(line), "%s\n", c->request);
+    size_t line_len = strlen(line);
+    char reply[8192];
+    for (int i = 0; i < c->requests; i++) {
+        double t0 = now_sec();
+        size_t len = 0;
+        if (write(fd, line, line_len) != (ssize_t)line_len ||
+            !read_reply(fd, reply, sizeof(reply), &len)) {
+            c->failed++;
+        }
+        c->latency[i] = now_sec() - t0;
+        if (i == 0) {
+            size_t keep = len < sizeof(c->first) - 1 ? len : sizeof(c->first) - 1;
+            memcpy(c->first, reply, keep);
+            c->first[keep] = '\0';
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s SOCKET [connections] [requests] [request]\n", argv[0]);
+        fprintf(stderr, "Start the server first: forth_fast -q -s SOCKET [file.f]\n");
+        return 1;
+    }
+    int conns = argc > 2 ? atoi(argv[2]) : 8;
+    int requests = argc > 3 ? atoi(argv[3]) : 20000;
+    const char* request = argc > 4 ? argv[4] : ": REQ 0 1000 0 DO I + LOOP ; REQ 6 7 * .";
+    if (conns < 1 || requests < 1) return 1;
+    
+    // A request blocked on a channel must fail, not hold its worker
+    if (!probe(argv[1], "1 CHANNEL C C RECV", "error") ||
+        !probe(argv[1], "1 2 +", "ok")) {
+        return 1;
+    }
+    
+    client_t* clients = calloc((size_t)conns, sizeof(client_t));
+    double* latency = malloc(sizeof(double) * (size_t)conns * (size_t)requests);
+    pthread_t* threads = malloc(sizeof(pthread_t) * (size_t)conns);
+    
+    double t0 = now_sec();
+    for (int i = 0; i < conns; i++) {
+        clients[i].path = argv[1];
+        clients[i].request = request;
+        clients[i].requests = requests;
+        clients[i].latency = latency + (size_t)i * requests;
+        pthread_create(&threads[i], NULL, client, &clients[i]);
+    }
+    int failed = 0;
+    for (int i = 0; i < conns; i++) {
+        pthread_join(threads[i], NULL);
+        failed += clients[i].failed;
+    }
+    double elapsed = now_sec() - t0;
+    
+    size_t total = (size_t)conns * requests;
+    qsort(latency, total, sizeof(double), cmp_double);
+    printf("Request: %s\n", request);
+    printf("Reply:   %s", clients[0].first);
+    printf("\n%d connections x %d requests, %d failed\n", conns, requests, failed);
+    printf("%-20s %10.0f req/sec\n", "Throughput", total / elapsed);
+    printf("%-20s %10.1f us\n", "p50 latency", latency[total / 2] * 1e6);
+    printf("%-20s %10.1f us\n", "p99 latency", latency[total * 99 / 100] * 1e6);
+    printf("%-20s %10.1f us\n", "max latency", latency[total - 1] * 1e6);
+    
+    free(threads);
+    free(latency);
+    free(clients);
+    return failed ? 1 : 0;
+}
@@ -1,18 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
 #define FF_ENABLE_REPL
+#include <strings.h>
 #include "forth_fast.h"
+#ifdef FF_ENABLE_THREADS
+#include "forth_shard.h"
+#endif
+#if defined(FF_ENABLE_THREADS) && defined(__linux__)
+#define FF_ENABLE_SERVER
+#include "forth_server.h"
+#endif
+
+// SIGINT stops the running word at its next safepoint (or the server)
+static volatile sig_atomic_t* interrupt_flag;
+static volatile sig_atomic_t serve_stop;
+
+static void on_sigint(int sig) {
+    (void)sig;
+    if (interrupt_flag) *interrupt_flag = 1;
+}
 
 int main(int argc, char** argv) {
     forth_t vm;
-    init_forth(&vm);
-    
+    forth_sizes_t sizes = { FF_STACK_DEPTH, FF_RET_DEPTH, FF_DICT_SIZE, FF_MAX_WORDS };
     int quiet = 0;
+    const char* serve_path = NULL;
+    const char* process_word = NULL;
+#ifdef FF_ENABLE_THREADS
+    const char* reduce_word = NULL;
+    int threads = 0;
+#endif
     int arg_start = 1;
     
-    // Check for -q flag
-    if (argc > 1 && strcmp(argv[1], "-q") == 0) {
-        quiet = 1;
-        arg_start = 2;
+    // Flags: -q quiet, -s PATH serve requests on a Unix socket after
+    // loading the file, -p WORD [-r REDUCE] run WORD over each line of
+    // the input file given after the program, -j N worker threads for
+    // these and PAR-DO (default: one per core), -m S,R,D,W data and
+    // return stack depths, dictionary bytes and word table entries
+    while (argc > arg_start && argv[arg_start][0] == '-') {
+        if (strcmp(argv[arg_start], "-q") == 0) {
+            quiet = 1;
+            arg_start++;
+        } else if (strcmp(argv[arg_start], "-m") == 0 && argc > arg_start + 1 &&
+                   sscanf(argv[arg_start + 1], "%d,%d,%d,%d", &sizes.data_stack,
+                          &sizes.return_stack, &sizes.dict, &sizes.words) == 4) {
+            arg_start += 2;
+        } else if (strcmp(argv[arg_start], "-s") == 0 && argc > arg_start + 1) {
+            serve_path = argv[arg_start + 1];
+            arg_start += 2;
+        } else if (strcmp(argv[arg_start], "-p") == 0 && argc > arg_start + 1) {
+            process_word = argv[arg_start + 1];
+            arg_start += 2;
+#ifdef FF_ENABLE_THREADS
+        } else if (strcmp(argv[arg_start], "-r") == 0 && argc > arg_start + 1) {
+            reduce_word = argv[arg_start + 1];
+            arg_start += 2;
+        } else if (strcmp(argv[arg_start], "-j") == 0 && argc > arg_start + 1) {
+            threads = atoi(argv[arg_start + 1]);
+            arg_start += 2;
+#endif
+        } else {
+            fprintf(stderr, "Usage: %s [-q] [-j threads] [-m stack,rstack,dict,words]\n"
+                            "       [-s socket | -p word [-r reduce]]\n"
+                            "       [file.f | file.fbc [code...]] [input]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (process_word && argc != arg_start + 2) {
+        fprintf(stderr, "-p needs a program and an input file\n");
+        return 1;
+    }
+    if (!init_forth_sized(&vm, &sizes)) {
+        fprintf(stderr, "Cannot create a VM with these sizes\n");
+        return 1;
+    }
+    
+    // No SA_RESTART: Ctrl-C at the prompt still ends the REPL
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_sigint;
+    sigemptyset(&sa.sa_mask);
+    interrupt_flag = &vm.ctx.interrupt;
+    sigaction(SIGINT, &sa, NULL);
+    
+#ifdef FF_ENABLE_THREADS
+    // Workers for PAR-DO and -p
+    forth_pool_t pool;
+    if (init_pool(&pool, threads)) {
+        vm.ctx.pool = &pool;
     }
+#endif
     
     if (!quiet) {
         printf("Fast Forth VM\n");
@@ -33,61 +109,17 @@ int main(int argc, char** argv) {
                 return 1;
             }
             
-            // Read and verify header
-            uint32_t magic;
-            uint16_t version;
-            if (fread(&magic, sizeof(magic), 1, fp) != 1 || magic != 0x46545448) {
-                fprintf(stderr, "Invalid bytecode file: bad magic\n");
-                fclose(fp);
-                return 1;
-            }
-            if (fread(&version, sizeof(version), 1, fp) != 1 || version != 1) {
-                fprintf(stderr, "Unsupported bytecode version\n");
-                fclose(fp);
-                return 1;
-            }
-            
-            addr_t saved_here;
-            int saved_word_count, saved_builtin_count;
-            fread(&saved_here, sizeof(saved_here), 1, fp);
-            fread(&saved_word_count, sizeof(saved_word_count), 1, fp);
-            fread(&saved_builtin_count, sizeof(saved_builtin_count), 1, fp);
-            
-            // Validate sizes
-            if (saved_here > FF_DICT_SIZE || saved_word_count > FF_MAX_WORDS) {
-                fprintf(stderr, "Bytecode too large for VM\n");
-                fclose(fp);
-                return 1;
-            }
-            
-            // Read dictionary
-            if (fread(vm.dict, 1, saved_here, fp) != saved_here) {
-                fprintf(stderr, "Failed to read dictionary\n");
-                fclose(fp);
-                return 1;
-            }
-            
-            // Read word table
-            if (fread(vm.words, sizeof(word_t), saved_word_count, fp) != 
-                (size_t)saved_word_count) {
-                fprintf(stderr, "Failed to read word table\n");
-                fclose(fp);
-                return 1;
-            }
-            
-            vm.here = saved_here;
-            vm.word_count = saved_word_count;
-            vm.builtin_count = saved_builtin_count;
-            
+            int loaded = load_bytecode(&vm.image, &vm.ctx, fp);
             fclose(fp);
+            if (!loaded) return 1;
             if (!quiet) {
                 printf("Loaded bytecode from %s (%d bytes, %d words)\n", 
-                       filename, vm.here, vm.word_count);
+                       filename, vm.image.here, vm.image.word_count);
                 printf("--------------------------------\n");
             }
             
             // If more arguments, execute them as Forth code and exit
-            if (argc > arg_start + 1) {
+            if (argc > arg_start + 1 && !process_word) {
                 for (int i = arg_start + 1; i < argc; i++) {
                     interpret_line(&vm, argv[i]);
                 }
@@ -115,7 +147,38 @@ int main(int argc, char** argv) {
         }
     }
     
+    if (serve_path) {
+#ifdef FF_ENABLE_SERVER
+        signal(SIGPIPE, SIG_IGN);
+        interrupt_flag = &serve_stop;
+        sigaction(SIGTERM, &sa, NULL);
+        if (!quiet) {
+            fprintf(stderr, "Serving on %s\n", serve_path);
+        }
+        int rc = serve_forth(&vm, serve_path, threads, &serve_stop);
+        if (vm.ctx.pool) free_pool(vm.ctx.pool);
+        return rc;
+#else
+        fprintf(stderr, "Server mode not available in this build\n");
+        return 1;
+#endif
+    }
+    
+    if (process_word) {
+#ifdef FF_ENABLE_THREADS
+        int rc = process_file(&vm, vm.ctx.pool, process_word, reduce_word, argv[arg_start + 1]);
+        if (vm.ctx.pool) free_pool(vm.ctx.pool);
+        return rc;
+#else
+        fprintf(stderr, "File processing not available in this build\n");
+        return 1;
+#endif
+    }
+    
     repl(&vm);
     
+#ifdef FF_ENABLE_THREADS
+    if (vm.ctx.pool) free_pool(vm.ctx.pool);
+#endif
     return 0;
 }
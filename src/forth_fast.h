@@ -4,14 +4,34 @@
 #ifndef FORTH_FAST_H
 #define FORTH_FAST_H
 
+#include <stdarg.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <signal.h>
+#ifdef FF_ENABLE_THREADS
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+#ifdef FF_ENABLE_FORK
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef FF_ENABLE_SANDBOX
+#include <fcntl.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-// Configuration
+// Configuration. Stack depths, dictionary size and word capacity are
+// the defaults for init_forth(); init_forth_sized() picks them per VM.
 #ifndef FF_STACK_DEPTH
 #define FF_STACK_DEPTH 128
 #endif
@@ -22,11 +42,50 @@
 #define FF_DICT_SIZE 4096
 #endif
 #ifndef FF_MAX_WORDS
-#define FF_MAX_WORDS 128
+#define FF_MAX_WORDS 192
 #endif
 #ifndef FF_NAME_MAX
 #define FF_NAME_MAX 15
 #endif
+#ifndef FF_DATA_SIZE
+#define FF_DATA_SIZE 256
+#endif
+#ifndef FF_MAX_TASKS
+#define FF_MAX_TASKS 4
+#endif
+#ifndef FF_MAX_CHANNELS
+#define FF_MAX_CHANNELS 16
+#endif
+#ifndef FF_CHANNEL_MAX
+#define FF_CHANNEL_MAX (1 << 20)    // Largest channel capacity, in cells
+#endif
+#ifndef FF_LOAD_PAR_MAX
+#define FF_LOAD_PAR_MAX 32  // Files per LOAD-PAR
+#endif
+#ifndef FF_PAGE_SHIFT
+#define FF_PAGE_SHIFT 6     // Dirty tracking granularity: 64-byte dictionary pages
+#endif
+#define FF_PAGE_SIZE (1 << FF_PAGE_SHIFT)
+#define FF_CACHE_LINE 64    // Alignment of the separately allocated segments
+#define FF_DICT_MAX 0xFFC0  // Largest dictionary addr_t can cover
+// Private data area addresses start here, well above any dictionary address
+#define FF_DATA_BASE 0x10000
+// The context's current input record (see forth_shard.h) is mapped here
+#define FF_INPUT_BASE 0x20000
+// The context's heap (ALLOCATE) is mapped here
+#define FF_HEAP_BASE 0x1000000
+#ifdef FF_ENABLE_SANDBOX
+// Sandboxed memory: each dictionary sits at the start of a reserved
+// window covering every address below FF_SANDBOX_SPAN plus a guard
+// page. Pages past the dictionary are inaccessible, so @ ! C@ C! +!
+// into the window need no bounds check; a stray access faults and ends
+// the word with FF_FAULT. Each context's stacks are whole pages
+// between guard pages, so the interpreter pushes and pops unchecked;
+// overflow and underflow end the word with FF_STACK_FAULT. Every
+// context is a few mappings, which bounds how many can exist
+// (vm.max_map_count on Linux).
+#define FF_SANDBOX_SPAN 0x10000
+#endif
 
 // Bytecode opcodes - small numbers, great for 8-bit CPUs
 typedef enum {
@@ -107,12 +166,97 @@ typedef enum {
     OP_CLEAR,       // CLEAR ( ... -- ) clear stack
     OP_WORDS,       // WORDS ( -- ) list all words
     OP_SEE,         // SEE ( -- ) decompile word (parsed)
+    // Multitasking
+    OP_PAUSE,       // PAUSE ( -- ) switch to the next task
+    OP_KEYQ,        // KEY? ( -- flag ) input ready
+    // Parallel loops
+    OP_PAR_DO,      // PAR-DO ( acc limit index -- acc' ) kind + end address follow
+    // Channels
+    OP_SEND,        // SEND ( x ch -- )
+    OP_RECV,        // RECV ( ch -- x )
+    OP_TRY_RECV,    // TRY-RECV ( ch -- x -1 | 0 )
+    // Atomics (aligned cells only)
+    OP_ATOMIC_LOAD, // ATOMIC@ ( addr -- x )
+    OP_ATOMIC_STORE,// ATOMIC! ( x addr -- )
+    OP_ATOMIC_ADD,  // ATOMIC+! ( n addr -- )
+    OP_CAS,         // CAS ( old new addr -- flag )
+    OP_FENCE,       // FENCE ( -- ) full memory barrier
+    // Heap
+    OP_ALLOCATE,    // ALLOCATE ( u -- a-addr ior )
+    OP_FREE,        // FREE ( a-addr -- ior )
+    OP_RESIZE,      // RESIZE ( a-addr u -- a-addr' ior )
+    // Cells and alignment
+    OP_CELLS,       // CELLS ( n -- n*cell )
+    OP_CELL_PLUS,   // CELL+ ( addr -- addr+cell )
+    OP_ALIGNED,     // ALIGNED ( addr -- addr' ) round up to a cell boundary
+    OP_ALIGN,       // ALIGN ( -- ) align HERE
+    // Bulk memory
+    OP_MOVE,        // MOVE ( src dst u -- ) copy u bytes, overlap allowed
+    OP_CMOVE,       // CMOVE ( src dst u -- ) copy from low addresses up
+    OP_CMOVE_UP,    // CMOVE> ( src dst u -- ) copy from high addresses down
+    OP_FILL,        // FILL ( addr u char -- )
+    OP_ERASE,       // ERASE ( addr u -- ) fill with zeros
+    OP_COMPARE,     // COMPARE ( a1 u1 a2 u2 -- n ) -1, 0 or 1
+    // Double cells
+    OP_MSTAR,       // M* ( n1 n2 -- d )
+    OP_UMSTAR,      // UM* ( u1 u2 -- ud )
+    OP_UMSLASHMOD,  // UM/MOD ( ud u -- urem uquot )
+    OP_SMSLASHREM,  // SM/REM ( d n -- rem quot ) symmetric
+    OP_DPLUS,       // D+ ( d1 d2 -- d3 )
+    OP_DMINUS,      // D- ( d1 d2 -- d3 )
+    OP_DDOT,        // D. ( d -- )
+    // Bignums
+    OP_BIG_INIT,    // BIG-INIT ( cap big -- ) empty bignum of cap limbs
+    OP_BIG_STORE,   // BIG! ( u big -- )
+    OP_BIG_MULN,    // BIG*N ( big u -- ior ) big *= u
+    OP_BIG_ADD,     // BIG+ ( big1 big2 -- ior ) big1 += big2
+    OP_BIG_MUL,     // BIG* ( big a b -- ior ) big = a * b
+    OP_BIG_DIVN,    // BIG/N ( big u -- rem ior ) big /= u
+    OP_BIG_COMPARE, // BIGCOMPARE ( big1 big2 -- n ) -1, 0 or 1; -9 if bad
+    OP_BIG_TO_STR,  // BIG>STR ( big addr u -- u' ) decimal, 0 if u is short
+    OP_BIG_DOT,     // BIG. ( big -- )
     OP_MAX          // Marker
 } opcode_t;
 
+// Cells are 32 bits, or 64 with -DFF_CELL_BITS=64. Double cells (M*,
+// UM/MOD, D+ ...) are twice that; 64-bit cells need __int128.
+#ifndef FF_CELL_BITS
+#define FF_CELL_BITS 32
+#endif
+#if FF_CELL_BITS == 64
+typedef int64_t cell_t;
+typedef uint64_t ucell_t;
+__extension__ typedef __int128 dcell_t;
+__extension__ typedef unsigned __int128 udcell_t;
+#define FF_CELL_MIN INT64_MIN
+#define FF_CELL_MAX INT64_MAX
+#elif FF_CELL_BITS == 32
 typedef int32_t cell_t;
+typedef uint32_t ucell_t;
+typedef int64_t dcell_t;
+typedef uint64_t udcell_t;
+#define FF_CELL_MIN INT32_MIN
+#define FF_CELL_MAX INT32_MAX
+#else
+#error "FF_CELL_BITS must be 32 or 64"
+#endif
 typedef uint16_t addr_t;
 
+// execute() results
+typedef enum {
+    FF_OK = 0,          // Word ran to completion
+    FF_OUT_OF_FUEL,     // Fuel exhausted; refill ctx->fuel and resume()
+    FF_INTERRUPTED,     // ctx->interrupt was set; resume() or reset stacks
+    FF_ERROR,           // Bad opcode
+    FF_BLOCKED,         // step(): KEY has no input or a channel is not
+                        // ready; resume() once it may proceed
+    FF_FAULT,           // Access outside the sandbox (FF_ENABLE_SANDBOX),
+                        // a PAR-DO slice failed or a batch item never ran
+    FF_STACK_FAULT      // Stack overflow or underflow (FF_ENABLE_SANDBOX)
+} forth_status_t;
+
+#define FF_FUEL_UNLIMITED INT64_MAX
+
 // I/O callbacks for flexibility (can be overridden for embedded systems)
 typedef struct {
     int (*getchar_fn)(void);
@@ -122,6 +266,8 @@ typedef struct {
     int (*fclose_fn)(FILE* fp);
     char* (*fgets_fn)(char* buf, int size, FILE* fp);
     int (*fputs_fn)(const char* str, FILE* fp);
+    int (*key_ready_fn)(void);  // Optional: nonzero if KEY won't block
+    void (*error_fn)(const char* msg);  // Optional: diagnostics, else stderr
 } forth_io_t;
 
 // Default flush implementation
@@ -140,22 +286,441 @@ typedef struct {
     uint8_t flags;
 } word_t;
 
+// word_t flags
+#define FF_WORD_MARKER 0x01 // Defined by MARKER: running it forgets from there
+#define FF_WORD_USER 0x02   // Defined by USER (LIT addr EXIT): owns a USER cell
+#define FF_WORD_CHANNEL 0x04 // Defined by CHANNEL (LIT n EXIT): owns channel n
+
+#ifdef FF_ENABLE_THREADS
+// Channel: bounded lock-free MPMC ring of cells (Vyukov's queue).
+// Each slot carries a sequence number telling producers and consumers
+// whose turn it is, so both sides only CAS their own position counter.
+// With one producer and one consumer those CASes never contend.
 typedef struct {
-    // Data stack
-    cell_t ds[FF_STACK_DEPTH];
-    int sp;
+    _Atomic size_t seq;
+    cell_t value;
+} forth_slot_t;
+
+typedef struct {
+    forth_slot_t* slots;
+    size_t mask;
+    char pad0[64];
+    _Atomic size_t head;    // Next slot to send into
+    char pad1[64];
+    _Atomic size_t tail;    // Next slot to receive from
+    char pad2[64];
+} forth_channel_t;
+
+// Capacity is rounded up to a power of two. 0 if it is over
+// FF_CHANNEL_MAX or out of memory; ch is then safe to free_channel().
+static inline int init_channel(forth_channel_t* ch, size_t capacity) {
+    memset(ch, 0, sizeof(*ch));
+    if (capacity > FF_CHANNEL_MAX) return 0;
+    size_t n = 2;
+    while (n < capacity) n <<= 1;
+    ch->slots = malloc(n * sizeof(forth_slot_t));
+    if (!ch->slots) return 0;
+    for (size_t i = 0; i < n; i++) {
+        atomic_init(&ch->slots[i].seq, i);
+    }
+    ch->mask = n - 1;
+    atomic_init(&ch->head, 0);
+    atomic_init(&ch->tail, 0);
+    return 1;
+}
+
+static inline void free_channel(forth_channel_t* ch) {
+    free(ch->slots);
+    ch->slots = NULL;
+}
+
+// Nonblocking send: 0 if the channel is full
+static inline int channel_try_send(forth_channel_t* ch, cell_t x) {
+    size_t pos = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    while (1) {
+        forth_slot_t* slot = &ch->slots[pos & ch->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ch->head, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                slot->value = x;
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&ch->head, memory_order_relaxed);
+        }
+    }
+}
+
+// Nonblocking receive: 0 if the channel is empty
+static inline int channel_try_recv(forth_channel_t* ch, cell_t* x) {
+    size_t pos = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    while (1) {
+        forth_slot_t* slot = &ch->slots[pos & ch->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ch->tail, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                *x = slot->value;
+                atomic_store_explicit(&slot->seq, pos + ch->mask + 1, memory_order_release);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+        }
+    }
+}
+
+// Whether a send (or receive) would succeed right now
+static inline int channel_ready(forth_channel_t* ch, int sending) {
+    _Atomic size_t* counter = sending ? &ch->head : &ch->tail;
+    size_t pos = atomic_load_explicit(counter, memory_order_acquire);
+    size_t seq = atomic_load_explicit(&ch->slots[pos & ch->mask].seq, memory_order_acquire);
+    return seq == pos + (sending ? 0 : 1);
+}
+
+// Blocking versions for host threads
+static inline void channel_send(forth_channel_t* ch, cell_t x) {
+    while (!channel_try_send(ch, x)) sched_yield();
+}
+
+static inline cell_t channel_recv(forth_channel_t* ch) {
+    cell_t x;
+    while (!channel_try_recv(ch, &x)) sched_yield();
+    return x;
+}
+#endif // FF_ENABLE_THREADS
+
+// Heap: ALLOCATE/FREE/RESIZE blocks addressed from FF_HEAP_BASE. Each
+// context has its own heap (like its USER area), created on the first
+// ALLOCATE, so threads never contend for it. Blocks of up to 2048 bytes
+// (header included) come from power-of-two size classes, each a free
+// list plus the 4 KB slab being carved: O(1) either way. Larger blocks
+// take whole slabs and are reused first fit. heap_reset() drops every
+// block at once for per-request lifetimes; reset_vm() calls it. Memory
+// past top is always zero, so one request's data never reaches the next.
+#ifndef FF_HEAP_MAX
+#define FF_HEAP_MAX 0x1000000   // Bytes per context
+#endif
+#define FF_HEAP_SLAB 4096
+#define FF_HEAP_CLASSES 8       // 16 to 2048 bytes
+#define FF_HEAP_FREED 0xFFFFFFFFu
+
+typedef struct {
+    uint32_t cap;   // Block bytes, header included
+    uint32_t len;   // Bytes asked for, FF_HEAP_FREED once freed
+} forth_block_t;
+
+// Blocks are named by the offset of their payload (never 0), which is
+// also what the free lists link through
+typedef struct {
+    uint8_t* mem;
+    uint32_t size;      // Bytes allocated
+    uint32_t top;       // Bytes handed out as slabs or large blocks
+    uint32_t free[FF_HEAP_CLASSES];
+    uint32_t slab[FF_HEAP_CLASSES];     // Next block of each class's slab
+    uint32_t slab_end[FF_HEAP_CLASSES];
+    uint32_t large;     // Freed large blocks
+} forth_heap_t;
+
+static inline forth_block_t* heap_block(forth_heap_t* h, uint32_t off) {
+    return (forth_block_t*)(h->mem + off - sizeof(forth_block_t));
+}
+
+static inline uint32_t heap_next(forth_heap_t* h, uint32_t off) {
+    uint32_t next;
+    memcpy(&next, h->mem + off, sizeof(next));
+    return next;
+}
+
+// Whether off names a block inside the heap with a plausible header
+static inline int heap_valid(forth_heap_t* h, uint32_t off) {
+    if (off < sizeof(forth_block_t) || off > h->top || (off & 7)) return 0;
+    uint32_t cap = heap_block(h, off)->cap;
+    int small = cap >= 16 && cap <= 16u << (FF_HEAP_CLASSES - 1) && !(cap & (cap - 1));
+    int large = cap > FF_HEAP_SLAB / 2 && !(cap & (FF_HEAP_SLAB - 1));
+    return (small || large) && cap <= h->top - (off - sizeof(forth_block_t));
+}
+
+// Whether off names a block on a free list. A live block there means
+// the list was overwritten after FREE; popping it would hand it out twice.
+static inline int heap_freed(forth_heap_t* h, uint32_t off) {
+    return heap_valid(h, off) && heap_block(h, off)->len == FF_HEAP_FREED;
+}
+
+// Size class holding need bytes (header included, at most 2048)
+static inline int heap_class(uint32_t need) {
+    int k = 0;
+    while ((16u << k) < need) k++;
+    return k;
+}
+
+// Take n bytes from the top, growing the heap. 0 if out of memory.
+static int heap_grow(forth_heap_t* h, uint32_t n, uint32_t* at) {
+    if (n > FF_HEAP_MAX - h->top) return 0;
+    if (h->top + n > h->size) {
+        uint32_t size = h->size ? h->size : 16 * FF_HEAP_SLAB;
+        while (size < h->top + n) size *= 2;
+        if (size > FF_HEAP_MAX) size = FF_HEAP_MAX;
+        uint8_t* mem = realloc(h->mem, size);
+        if (!mem) return 0;
+        memset(mem + h->size, 0, size - h->size);
+        h->mem = mem;
+        h->size = size;
+    }
+    *at = h->top;
+    h->top += n;
+    return 1;
+}
+
+// A block of len bytes, 0 if out of memory. The payload is not cleared.
+static uint32_t heap_alloc(forth_heap_t* h, uint32_t len) {
+    if (!h || len > FF_HEAP_MAX) return 0;
+    uint32_t need = len + sizeof(forth_block_t);
+    uint32_t cap, at;
+    if (need <= 16u << (FF_HEAP_CLASSES - 1)) {
+        int k = heap_class(need);
+        cap = 16u << k;
+        uint32_t off = h->free[k];
+        if (off && heap_freed(h, off) && heap_block(h, off)->cap == cap) {
+            h->free[k] = heap_next(h, off);
+            heap_block(h, off)->len = len;
+            return off;
+        }
+        h->free[k] = 0;     // Empty, or overwritten after FREE
+        if (h->slab[k] == h->slab_end[k]) {
+            if (!heap_grow(h, FF_HEAP_SLAB, &at)) return 0;
+            h->slab[k] = at;
+            h->slab_end[k] = at + FF_HEAP_SLAB;
+        }
+        at = h->slab[k];
+        h->slab[k] += cap;
+    } else {
+        cap = (need + FF_HEAP_SLAB - 1) & ~(uint32_t)(FF_HEAP_SLAB - 1);
+        for (uint32_t* link = &h->large; *link; link = (uint32_t*)(h->mem + *link)) {
+            uint32_t off = *link;
+            if (!heap_freed(h, off)) {
+                *link = 0;
+                break;
+            }
+            if (heap_block(h, off)->cap >= cap) {
+                *link = heap_next(h, off);
+                heap_block(h, off)->len = len;
+                return off;
+            }
+        }
+        if (!heap_grow(h, cap, &at)) return 0;
+    }
+    forth_block_t* b = (forth_block_t*)(h->mem + at);
+    b->cap = cap;
+    b->len = len;
+    return at + sizeof(forth_block_t);
+}
+
+// Return a block to its free list. 0 if off is not a live block.
+static int heap_free(forth_heap_t* h, uint32_t off) {
+    if (!h || !heap_valid(h, off) || heap_block(h, off)->len == FF_HEAP_FREED) return 0;
+    forth_block_t* b = heap_block(h, off);
+    uint32_t* list = b->cap > 16u << (FF_HEAP_CLASSES - 1) ? &h->large : &h->free[heap_class(b->cap)];
+    b->len = FF_HEAP_FREED;
+    memcpy(h->mem + off, list, sizeof(*list));
+    *list = off;
+    return 1;
+}
+
+// Grow or shrink a block, in place if it fits. 0 if off is not a live
+// block or out of memory (the block is then unchanged).
+static uint32_t heap_resize(forth_heap_t* h, uint32_t off, uint32_t len) {
+    if (!h || !heap_valid(h, off) || heap_block(h, off)->len == FF_HEAP_FREED) return 0;
+    if (len <= FF_HEAP_MAX && len + sizeof(forth_block_t) <= heap_block(h, off)->cap) {
+        heap_block(h, off)->len = len;
+        return off;
+    }
+    uint32_t moved = heap_alloc(h, len);
+    if (!moved) return 0;
+    uint32_t keep = heap_block(h, off)->len;
+    memcpy(h->mem + moved, h->mem + off, keep < len ? keep : len);
+    heap_free(h, off);
+    return moved;
+}
+
+// Free every block at once, keeping the memory (cleared) for reuse
+static inline void heap_reset(forth_heap_t* h) {
+    if (!h) return;
+    if (h->top) memset(h->mem, 0, h->top);
+    h->top = 0;
+    h->large = 0;
+    memset(h->free, 0, sizeof(h->free));
+    memset(h->slab, 0, sizeof(h->slab));
+    memset(h->slab_end, 0, sizeof(h->slab_end));
+}
+
+static inline void free_heap(forth_heap_t* h) {
+    if (h) free(h->mem);
+    free(h);
+}
+
+// Code image: dictionary and word table. Compiled once, then shared
+// read-only by any number of execution contexts (and threads).
+typedef struct {
+    // Dictionary (bytecode) of dict_size bytes, followed in the same
+    // cache-line-aligned allocation by the dirty page bitmap
+    uint8_t* dict;
+    addr_t here;    // Next free position
+    int dict_size;
+    
+    // Word list, max_words entries, allocated separately
+    word_t* words;
+    int word_count;
+    int max_words;
+    
+    // Primitives start address (words defined before this are built-in)
+    int builtin_count;
+    
+    // Next free offset in each context's private data area (see USER)
+    int data_here;
+    
+    // Dictionary pages written since the last reset_vm(), one bit each,
+    // and the lowest word slot written (see the VM pool)
+    uint64_t* dirty;
+    int words_low;
     
-    // Return stack (mixed: addresses for calls, cells for loop counters)
-    cell_t rs[FF_RET_DEPTH];
+    // Call counts by target address while profiling (PROFILE), else
+    // NULL; RELAYOUT places words by them
+    uint32_t* calls;
+    
+    // Bytes mapped from a snapshot (fork_vm) holding the dictionary and
+    // the word table, 0 if they were allocated
+    size_t mapped;
+    
+#ifdef FF_ENABLE_THREADS
+    // Channels, referenced from Forth by number (1-based); owned ones
+    // were created by CHANNEL and are freed with the image
+    forth_channel_t* channels[FF_MAX_CHANNELS];
+    uint8_t channel_owned[FF_MAX_CHANNELS];
+    int channel_count;
+#endif
+} forth_image_t;
+
+#ifdef FF_ENABLE_THREADS
+typedef struct forth_pool forth_pool_t;
+#endif
+
+// Execution context: everything execute() mutates. Cheap to create,
+// one per thread (or per concurrent activity) on a shared image.
+typedef struct forth_ctx forth_ctx_t;
+struct forth_ctx {
+    // Hot fields first, sharing one cache line: the stacks (one
+    // cache-line-aligned allocation, see init_ctx_sized), their depths,
+    // and the safepoint state
+    cell_t* ds;     // Data stack
+    cell_t* rs;     // Return stack (addresses for calls, loop counters)
+    int sp;
     int rp;
+    int ds_size;
+    int rs_size;
+    int64_t fuel;
+    volatile sig_atomic_t interrupt;
+    addr_t pc;
     
-    // Dictionary (bytecode)
-    uint8_t dict[FF_DICT_SIZE];
-    addr_t here;    // Next free position
+    // Private data area, addressed from FF_DATA_BASE (USER variables)
+    _Alignas(cell_t) uint8_t data[FF_DATA_SIZE];
     
-    // Word list
-    word_t words[FF_MAX_WORDS];
-    int word_count;
+    // Input record the host points the context at, from FF_INPUT_BASE
+    uint8_t* input;
+    cell_t input_len;
+    
+    // Heap for ALLOCATE, NULL until first used
+    forth_heap_t* heap;
+    
+    // I/O callbacks
+    forth_io_t io;
+    
+    // Cooperative tasks: ring of contexts PAUSE cycles through
+    // (a lone context points to itself); pc is where to resume
+    forth_ctx_t* next;
+    
+    // Bounded execution: fuel is spent at backward branches, LOOP, CALL
+    // and each retry of a blocked SEND/RECV; interrupt may be set by a
+    // signal handler or another thread. Both are checked at those
+    // safepoints. current is the task that
+    // was running when execution suspended.
+    forth_ctx_t* current;
+    
+    // Set by step() and the server: KEY, SEND and RECV return FF_BLOCKED
+    // instead of waiting when no other task could run meanwhile
+    int no_block;
+    
+    // PAR-DO slice: the context running the loop, whose USER area,
+    // heap and input record the slice uses, and the interrupt flag of
+    // its execution, checked instead of interrupt (both NULL otherwise)
+    forth_ctx_t* parent;
+    volatile sig_atomic_t* interrupt_at;
+    
+    // PAR-DO that ran out of fuel or was interrupted on this context;
+    // running it again resumes its slices (NULL otherwise)
+    struct forth_par_parked* par;
+    
+#ifdef FF_ENABLE_THREADS
+    // Workers for PAR-DO (NULL: run parallel loops sequentially)
+    forth_pool_t* pool;
+    
+    // Bit (n - 1) % 64 set for each channel n SEND/RECV moved a cell
+    // through; the scheduler wakes fibers parked on those channels
+    uint64_t channels_used;
+#endif
+};
+
+// Relocation log of a segment: a file compiled on its own (LOAD-PAR)
+// at the current end of the dictionary, to be moved by the linker
+typedef enum {
+    FF_RELOC_ADDR = 0,  // Dictionary address, moves if inside the segment
+    FF_RELOC_WORD,      // xt of existing word ref, resolved again by name
+    FF_RELOC_EXTERN,    // Call to a word not yet defined, name externs[ref]
+    FF_RELOC_DATA       // USER address, moves with the segment's data
+} forth_reloc_kind_t;
+
+typedef struct {
+    addr_t at;          // Operand location
+    uint8_t size;       // 2 (address operand) or sizeof(cell_t) (LIT)
+    uint8_t kind;
+    int16_t ref;
+} forth_reloc_t;
+
+typedef struct {
+    addr_t base;        // Dictionary, words and USER area start
+    int base_words;
+    int base_data;
+    forth_reloc_t* relocs;
+    int reloc_count, reloc_cap;
+    char (*externs)[FF_NAME_MAX + 1];
+    int extern_count, extern_cap;
+    int failed;
+} forth_segment_t;
+
+// Segment sizes of a VM, fixed when it is created
+typedef struct {
+    int data_stack;     // Cells
+    int return_stack;   // Cells
+    int dict;           // Bytes, up to FF_DICT_MAX
+    int words;          // Word table entries
+} forth_sizes_t;
+
+// Full VM: an image, its primary context and the compiler state
+typedef struct {
+    forth_image_t image;
+    forth_ctx_t ctx;
+    
+    // Background tasks (TASK), linked into ctx's ring when activated
+    forth_ctx_t tasks[FF_MAX_TASKS];
+    int task_count;
     
     // Compilation state
     int compiling;
@@ -165,352 +730,1090 @@ typedef struct {
     addr_t cstack[32];
     int csp;
     
-    // I/O callbacks
-    forth_io_t io;
+    // Set while compiling a segment: address operands are logged
+    forth_segment_t* seg;
     
-    // Primitives start address (words defined before this are built-in)
-    int builtin_count;
+    // BYE, QUIT and EXIT end the line instead of the process (servers)
+    int no_exit;
 } forth_t;
 
+// Text output through the context's I/O callbacks
+static inline void io_print(forth_ctx_t* ctx, const char* str) {
+    if (!ctx->io.putchar_fn) return;
+    while (*str) ctx->io.putchar_fn((unsigned char)*str++);
+    if (ctx->io.flush_fn) ctx->io.flush_fn();
+}
+
+// Formatted text output, as io_print()
+static void io_printf(forth_ctx_t* ctx, const char* fmt, ...) {
+    char msg[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    io_print(ctx, msg);
+}
+
+// Diagnostics through the context's error callback (stderr if unset)
+static void io_error(forth_ctx_t* ctx, const char* fmt, ...) {
+    char msg[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    if (ctx->io.error_fn) ctx->io.error_fn(msg);
+    else fputs(msg, stderr);
+}
+
+// Double cells on the stack: the low cell, then the high cell on top
+static inline dcell_t make_double(cell_t lo, cell_t hi) {
+    return (dcell_t)(((udcell_t)(ucell_t)hi << FF_CELL_BITS) | (ucell_t)lo);
+}
+
+static inline cell_t double_hi(dcell_t d) {
+    return (cell_t)((udcell_t)d >> FF_CELL_BITS);
+}
+
+// Decimal text of d and a space (printf has no 128-bit conversion)
+static inline void double_str(char* buf, dcell_t d) {
+    char digits[48];
+    int n = 0;
+    udcell_t u = d < 0 ? -(udcell_t)d : (udcell_t)d;
+    do {
+        digits[n++] = (char)('0' + (int)(u % 10));
+        u /= 10;
+    } while (u);
+    if (d < 0) *buf++ = '-';
+    while (n) *buf++ = digits[--n];
+    *buf++ = ' ';
+    *buf = '\0';
+}
+
 // Stack operations - simple and fast
-#define PUSH(vm, val) do { if ((vm)->sp < FF_STACK_DEPTH) (vm)->ds[(vm)->sp++] = (val); } while(0)
-#define POP(vm) ((vm)->sp > 0 ? (vm)->ds[--(vm)->sp] : 0)
-#define TOS(vm) ((vm)->ds[(vm)->sp - 1])
-#define NOS(vm) ((vm)->ds[(vm)->sp - 2])
+#define PUSH(ctx, val) do { if ((ctx)->sp < (ctx)->ds_size) (ctx)->ds[(ctx)->sp++] = (val); } while(0)
+#define POP(ctx) ((ctx)->sp > 0 ? (ctx)->ds[--(ctx)->sp] : 0)
+#define TOS(ctx) ((ctx)->ds[(ctx)->sp - 1])
+#define NOS(ctx) ((ctx)->ds[(ctx)->sp - 2])
+
+// Cells are little-endian in memory. On little-endian hosts that is
+// the native order, so a cell is one load or store.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static inline cell_t load_cell(const uint8_t* m) {
+    cell_t c;
+    memcpy(&c, m, sizeof(c));
+    return c;
+}
+
+static inline void store_cell(uint8_t* m, cell_t c) {
+    memcpy(m, &c, sizeof(c));
+}
+#else
+static inline cell_t load_cell(const uint8_t* m) {
+    ucell_t c = 0;
+    for (size_t i = 0; i < sizeof(cell_t); i++) {
+        c |= (ucell_t)m[i] << (i * 8);
+    }
+    return (cell_t)c;
+}
+
+static inline void store_cell(uint8_t* m, cell_t c) {
+    for (size_t i = 0; i < sizeof(cell_t); i++) {
+        m[i] = (c >> (i * 8)) & 0xFF;
+    }
+}
+#endif
+
+// Hardware atomics (native byte order, same as @ on little-endian hosts)
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_OR(p, v) __atomic_fetch_or((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_CAS(p, old, v) __atomic_compare_exchange_n((p), (old), (v), 0, \
+                                  __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+// Single-threaded targets: plain memory operations
+#define ATOMIC_LOAD(p) (*(p))
+#define ATOMIC_STORE(p, v) (*(p) = (v))
+#define ATOMIC_ADD(p, v) (*(p) += (v))
+#define ATOMIC_OR(p, v) (*(p) |= (v))
+#define ATOMIC_CAS(p, old, v) (*(p) == *(old) ? (*(p) = (v), 1) : (*(old) = *(p), 0))
+#define ATOMIC_FENCE() ((void)0)
+#endif
+
+// Set bit in a dirty bitmap word that threads sharing the image may
+// update at once; the locked instruction runs only when the bit is new
+static inline void set_dirty_bit(uint64_t* w, uint64_t bit) {
+    if (!(ATOMIC_LOAD(w) & bit)) ATOMIC_OR(w, bit);
+}
+
+// Record a write to the dictionary page holding addr
+static inline void mark_page(forth_image_t* img, cell_t addr) {
+    cell_t pg = addr >> FF_PAGE_SHIFT;
+    set_dirty_bit(&img->dirty[pg >> 6], (uint64_t)1 << (pg & 63));
+}
+
+// Record a write to [addr, addr+len) of the dictionary
+static inline void mark_dirty(forth_image_t* img, cell_t addr, cell_t len) {
+    for (cell_t pg = addr >> FF_PAGE_SHIFT; pg <= (addr + len - 1) >> FF_PAGE_SHIFT; pg++) {
+        set_dirty_bit(&img->dirty[pg >> 6], (uint64_t)1 << (pg & 63));
+    }
+}
 
 // Dictionary operations
-static inline int emit_byte(forth_t* vm, uint8_t b) {
-    if (vm->here >= FF_DICT_SIZE) return 0;
-    vm->dict[vm->here++] = b;
+static inline int emit_byte(forth_image_t* img, uint8_t b) {
+    if (img->here >= img->dict_size) return 0;
+    mark_page(img, img->here);
+    img->dict[img->here++] = b;
     return 1;
 }
 
-static inline int emit_cell(forth_t* vm, cell_t c) {
+static inline int emit_cell(forth_image_t* img, cell_t c) {
     for (size_t i = 0; i < sizeof(cell_t); i++) {
-        if (!emit_byte(vm, (c >> (i * 8)) & 0xFF)) return 0;
+        if (!emit_byte(img, (c >> (i * 8)) & 0xFF)) return 0;
     }
     return 1;
 }
 
-static inline int emit_addr(forth_t* vm, addr_t a) {
-    if (!emit_byte(vm, a & 0xFF)) return 0;
-    if (!emit_byte(vm, (a >> 8) & 0xFF)) return 0;
+static inline int emit_addr(forth_image_t* img, addr_t a) {
+    if (!emit_byte(img, a & 0xFF)) return 0;
+    if (!emit_byte(img, (a >> 8) & 0xFF)) return 0;
     return 1;
 }
 
-static inline cell_t read_cell(forth_t* vm, addr_t* pc) {
-    cell_t c = 0;
-    for (size_t i = 0; i < sizeof(cell_t); i++) {
-        c |= ((cell_t)vm->dict[(*pc)++]) << (i * 8);
-    }
+static inline cell_t read_cell(forth_image_t* img, addr_t* pc) {
+    cell_t c = load_cell(&img->dict[*pc]);
+    *pc += sizeof(cell_t);
     return c;
 }
 
-static inline addr_t read_addr(forth_t* vm, addr_t* pc) {
-    addr_t a = vm->dict[(*pc)++];
-    a |= ((addr_t)vm->dict[(*pc)++]) << 8;
+static inline addr_t read_addr(forth_image_t* img, addr_t* pc) {
+    addr_t a = img->dict[(*pc)++];
+    a |= ((addr_t)img->dict[(*pc)++]) << 8;
     return a;
 }
 
 // Patch an address at a given location (for forward branches)
-static inline void patch_addr(forth_t* vm, addr_t location, addr_t target) {
-    vm->dict[location] = target & 0xFF;
-    vm->dict[location + 1] = (target >> 8) & 0xFF;
+static inline void patch_addr(forth_image_t* img, addr_t location, addr_t target) {
+    mark_dirty(img, location, 2);
+    img->dict[location] = target & 0xFF;
+    img->dict[location + 1] = (target >> 8) & 0xFF;
+}
+
+// Resolve a Forth address to memory: the shared dictionary, the
+// context's private data area, its heap or its input record. NULL if
+// [addr, addr+len) is out of range.
+static inline uint8_t* mem_at(forth_image_t* img, forth_ctx_t* ctx, cell_t addr, cell_t len) {
+    if (len < 0) return NULL;
+    if (addr >= 0 && len <= img->dict_size && addr <= img->dict_size - len) {
+        return &img->dict[addr];
+    }
+    if (ctx->parent) ctx = ctx->parent;     // PAR-DO slice
+    if (addr >= FF_DATA_BASE && len <= FF_DATA_SIZE && addr - FF_DATA_BASE <= FF_DATA_SIZE - len) {
+        return &ctx->data[addr - FF_DATA_BASE];
+    }
+    if (addr >= FF_HEAP_BASE && ctx->heap && len <= (cell_t)ctx->heap->top &&
+        addr - FF_HEAP_BASE <= (cell_t)ctx->heap->top - len) {
+        return &ctx->heap->mem[addr - FF_HEAP_BASE];
+    }
+    if (addr >= FF_INPUT_BASE && len <= ctx->input_len && addr - FF_INPUT_BASE <= ctx->input_len - len) {
+        return &ctx->input[addr - FF_INPUT_BASE];
+    }
+    return NULL;
+}
+
+// Whether addr is an aligned cell of the dictionary, the common case
+// for @ and !: one compare, and the cell lies within one dirty page.
+// Sandboxed, any aligned cell of the window will do: one mask test.
+static inline int dict_cell(const forth_image_t* img, cell_t addr) {
+#ifdef FF_ENABLE_SANDBOX
+    (void)img;
+    return !((ucell_t)addr & ~(ucell_t)(FF_SANDBOX_SPAN - sizeof(cell_t)));
+#else
+    return !(addr & (sizeof(cell_t) - 1)) &&
+           (ucell_t)addr <= (ucell_t)img->dict_size - sizeof(cell_t);
+#endif
+}
+
+// Whether addr is a byte of the dictionary (of the window, sandboxed)
+static inline int dict_byte(const forth_image_t* img, cell_t addr) {
+#ifdef FF_ENABLE_SANDBOX
+    (void)img;
+    return (ucell_t)addr < FF_SANDBOX_SPAN;
+#else
+    return (ucell_t)addr < (ucell_t)img->dict_size;
+#endif
+}
+
+// mem_at() for stores: also marks dictionary pages dirty
+static inline uint8_t* mem_store_at(forth_image_t* img, forth_ctx_t* ctx, cell_t addr, cell_t len) {
+    uint8_t* m = mem_at(img, ctx, addr, len);
+    if (m && addr < img->dict_size && len > 0) mark_dirty(img, addr, len);
+    return m;
+}
+
+// Naturally aligned cell for the atomic words, NULL if misaligned.
+// All memory areas start cell aligned, so checking addr is enough.
+static inline cell_t* cell_at(forth_image_t* img, forth_ctx_t* ctx, cell_t addr) {
+    if (addr & (sizeof(cell_t) - 1)) return NULL;
+    return (cell_t*)mem_at(img, ctx, addr, sizeof(cell_t));
+}
+
+static inline cell_t* cell_store_at(forth_image_t* img, forth_ctx_t* ctx, cell_t addr) {
+    if (addr & (sizeof(cell_t) - 1)) return NULL;
+    return (cell_t*)mem_store_at(img, ctx, addr, sizeof(cell_t));
+}
+
+// Bignums: unsigned integers in a cell-aligned buffer of cap+2 cells:
+// cap, len (limbs in use, at least one, the top one nonzero unless the
+// value is 0), then the limbs, least significant first. They may live
+// in the dictionary, the data area or the heap. A result that doesn't
+// fit in cap limbs fails with ior -11 and leaves the destination
+// undefined; a bad buffer fails with -9 (BIGCOMPARE gives -9 too) and
+// dividing by zero with -10.
+#define FF_BIG_BAD -9
+#define FF_BIG_ZERO -10
+#define FF_BIG_RANGE -11
+#if FF_CELL_BITS == 64
+#define FF_BIG_CHUNK 1000000000000000000ull  // Largest power of 10 in a limb
+#define FF_BIG_CHUNK_DIGITS 18
+#else
+#define FF_BIG_CHUNK 1000000000u
+#define FF_BIG_CHUNK_DIGITS 9
+#endif
+
+// The bignum at addr, NULL if misaligned, out of range or malformed
+static ucell_t* big_at(forth_image_t* img, forth_ctx_t* ctx, cell_t addr, int store) {
+    if (addr & (sizeof(cell_t) - 1)) return NULL;
+    const ucell_t* h = (const ucell_t*)mem_at(img, ctx, addr, 2 * sizeof(cell_t));
+    if (!h || h[0] < 1 || h[0] > FF_HEAP_MAX / sizeof(cell_t) || h[1] < 1 || h[1] > h[0]) {
+        return NULL;
+    }
+    cell_t bytes = (cell_t)((h[0] + 2) * sizeof(cell_t));
+    return (ucell_t*)(store ? mem_store_at(img, ctx, addr, bytes) : mem_at(img, ctx, addr, bytes));
 }
 
+static void big_init(forth_image_t* img, forth_ctx_t* ctx, cell_t addr, cell_t cap) {
+    if (addr & (sizeof(cell_t) - 1) || cap < 1 || cap > FF_HEAP_MAX / (cell_t)sizeof(cell_t)) return;
+    ucell_t* h = (ucell_t*)mem_store_at(img, ctx, addr, (cap + 2) * (cell_t)sizeof(cell_t));
+    if (!h) return;
+    h[0] = (ucell_t)cap;
+    h[1] = 1;
+    h[2] = 0;
+}
+
+static inline void big_trim(ucell_t* h) {
+    while (h[1] > 1 && h[h[1] + 1] == 0) h[1]--;
+}
+
+static cell_t big_mul_cell(ucell_t* h, ucell_t u) {
+    ucell_t* x = h + 2;
+    ucell_t len = h[1];
+    ucell_t carry = 0;
+    for (ucell_t i = 0; i < len; i++) {
+        udcell_t p = (udcell_t)x[i] * u + carry;
+        x[i] = (ucell_t)p;
+        carry = (ucell_t)(p >> FF_CELL_BITS);
+    }
+    if (carry) {
+        if (len == h[0]) return FF_BIG_RANGE;
+        x[h[1]++] = carry;
+    }
+    big_trim(h);
+    return 0;
+}
+
+// a += b; b may be a
+static cell_t big_add(ucell_t* a, const ucell_t* b) {
+    ucell_t n = a[1] > b[1] ? a[1] : b[1];
+    if (n > a[0]) return FF_BIG_RANGE;
+    ucell_t* x = a + 2;
+    const ucell_t* y = b + 2;
+    ucell_t la = a[1], lb = b[1];
+    ucell_t carry = 0;
+    for (ucell_t i = 0; i < n; i++) {
+        udcell_t s = (udcell_t)(i < la ? x[i] : 0) + (i < lb ? y[i] : 0) + carry;
+        x[i] = (ucell_t)s;
+        carry = (ucell_t)(s >> FF_CELL_BITS);
+    }
+    if (carry) {
+        if (n == a[0]) return FF_BIG_RANGE;
+        x[n++] = carry;
+    }
+    a[1] = n;
+    return 0;
+}
+
+// d = a * b, schoolbook; d must not overlap a or b
+static cell_t big_mul(ucell_t* d, const ucell_t* a, const ucell_t* b) {
+    ucell_t la = a[1], lb = b[1], cap = d[0];
+    if ((d < a + a[0] + 2 && a < d + cap + 2) || (d < b + b[0] + 2 && b < d + cap + 2)) {
+        return FF_BIG_BAD;
+    }
+    if (la + lb - 1 > cap) return FF_BIG_RANGE;
+    ucell_t n = la + lb < cap ? la + lb : cap;
+    ucell_t* z = d + 2;
+    memset(z, 0, n * sizeof(ucell_t));
+    for (ucell_t i = 0; i < la; i++) {
+        ucell_t carry = 0;
+        ucell_t ai = a[2 + i];
+        for (ucell_t j = 0; j < lb; j++) {
+            udcell_t p = (udcell_t)ai * b[2 + j] + z[i + j] + carry;
+            z[i + j] = (ucell_t)p;
+            carry = (ucell_t)(p >> FF_CELL_BITS);
+        }
+        if (i + lb < cap) z[i + lb] = carry;
+        else if (carry) return FF_BIG_RANGE;
+    }
+    d[1] = n;
+    big_trim(d);
+    return 0;
+}
+
+// h /= u, returning the remainder (u nonzero)
+static ucell_t big_div_cell(ucell_t* h, ucell_t u) {
+    ucell_t* x = h + 2;
+    ucell_t r = 0;
+    for (ucell_t i = h[1]; i-- > 0;) {
+        udcell_t cur = ((udcell_t)r << FF_CELL_BITS) | x[i];
+        x[i] = (ucell_t)(cur / u);
+        r = (ucell_t)(cur % u);
+    }
+    big_trim(h);
+    return r;
+}
+
+static int big_compare(const ucell_t* a, const ucell_t* b) {
+    if (a[1] != b[1]) return a[1] < b[1] ? -1 : 1;
+    for (ucell_t i = a[1]; i-- > 0;) {
+        if (a[2 + i] != b[2 + i]) return a[2 + i] < b[2 + i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Decimal digits of h, malloc'd and NUL-terminated, NULL if out of
+// memory. Division by the largest power of 10 in a limb takes a whole
+// chunk of digits per pass over the limbs.
+static char* big_decimal(const ucell_t* h, size_t* len) {
+    ucell_t n = h[1];
+    size_t room = (size_t)n * (FF_CELL_BITS / 3 + 1) + 2;
+    ucell_t* t = malloc((size_t)(n + 2) * sizeof(ucell_t));
+    char* out = malloc(room);
+    if (!t || !out) {
+        free(t);
+        free(out);
+        return NULL;
+    }
+    memcpy(t, h, (size_t)(n + 2) * sizeof(ucell_t));
+    // Chunks come out least significant first: fill from the end
+    char* p = out + room - 1;
+    *p = '\0';
+    do {
+        ucell_t chunk = big_div_cell(t, (ucell_t)FF_BIG_CHUNK);
+        int last = t[1] == 1 && t[2] == 0;
+        for (int k = 0; k < FF_BIG_CHUNK_DIGITS && (!last || chunk || k == 0); k++) {
+            *--p = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+        if (last) break;
+    } while (1);
+    *len = (size_t)(out + room - 1 - p);
+    memmove(out, p, *len + 1);
+    free(t);
+    return out;
+}
+
+// Index of the lowest set bit (x nonzero)
+#if defined(__GNUC__) || defined(__clang__)
+#define FF_CTZ64(x) __builtin_ctzll(x)
+#else
+static inline int FF_CTZ64(uint64_t x) {
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; n++; }
+    return n;
+}
+#endif
+
 // Word lookup
-static word_t* find_word(forth_t* vm, const char* name) {
-    for (int i = vm->word_count - 1; i >= 0; i--) {
-        if (strcmp(vm->words[i].name, name) == 0) {
-            return &vm->words[i];
+static word_t* find_word(forth_image_t* img, const char* name) {
+    for (int i = img->word_count - 1; i >= 0; i--) {
+        if (strcmp(img->words[i].name, name) == 0) {
+            return &img->words[i];
         }
     }
     return NULL;
 }
 
 // Add a word
-static word_t* add_word(forth_t* vm, const char* name, addr_t addr) {
-    if (vm->word_count >= FF_MAX_WORDS) return NULL;
-    word_t* w = &vm->words[vm->word_count++];
+static word_t* add_word(forth_image_t* img, const char* name, addr_t addr) {
+    if (img->word_count >= img->max_words) return NULL;
+    word_t* w = &img->words[img->word_count++];
     strncpy(w->name, name, FF_NAME_MAX);
     w->name[FF_NAME_MAX] = '\0';
     w->addr = addr;
     w->flags = 0;
+    if (img->word_count - 1 < img->words_low) img->words_low = img->word_count - 1;
     return w;
 }
 
-// THE HEART: Fast interpreter with switch dispatch
-// This is the secret sauce - inline everything, let compiler optimize
-static inline void execute(forth_t* vm, addr_t start) {
-    addr_t pc = start;
-    while (1) {
-        uint8_t op = vm->dict[pc++];
-        switch (op) {
-            case OP_EXIT:
-                if (vm->rp == 0) return;  // Exit interpreter
-                pc = vm->rs[--vm->rp];    // Return from word
-                break;
-                
-            case OP_LIT: {
-                cell_t val = read_cell(vm, &pc);
-                PUSH(vm, val);
-                break;
-            }
-            
-            case OP_CALL: {
-                addr_t addr = read_addr(vm, &pc);
-                vm->rs[vm->rp++] = pc;    // Save return address
-                pc = addr;                 // Jump to word
-                break;
-            }
-            
-            case OP_ADD: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a + b);
-                break;
-            }
-            
-            case OP_SUB: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a - b);
-                break;
-            }
-            
-            case OP_MUL: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a * b);
-                break;
-            }
-            
-            case OP_DIV: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, b ? a / b : 0);
-                break;
-            }
-            
-            case OP_DUP: {
-                if (vm->sp > 0) {
-                    PUSH(vm, TOS(vm));
-                }
+// Zeroed, cache-line-aligned allocation for a VM segment
+static inline void* alloc_segment(size_t size) {
+    size = (size + FF_CACHE_LINE - 1) & ~(size_t)(FF_CACHE_LINE - 1);
+    if (size == 0) size = FF_CACHE_LINE;
+    void* p = aligned_alloc(FF_CACHE_LINE, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+static inline size_t line_round(size_t size) {
+    return (size + FF_CACHE_LINE - 1) & ~(size_t)(FF_CACHE_LINE - 1);
+}
+
+// Words in the dirty page bitmap of a dictionary of size bytes
+static inline size_t dirty_words(int size) {
+    return ((size_t)((size + FF_PAGE_SIZE - 1) >> FF_PAGE_SHIFT) + 63) / 64;
+}
+
+#if defined(FF_ENABLE_FORK) || defined(FF_ENABLE_SANDBOX)
+static inline size_t page_round(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) & ~(page - 1);
+}
+#endif
+
+#ifdef FF_ENABLE_SANDBOX
+// Bytes of a dictionary window: the span and a guard page, so a cell
+// starting anywhere in the span ends inside the window
+static inline size_t sandbox_window(void) {
+    return page_round(FF_SANDBOX_SPAN + 1);
+}
+
+// Reserve size bytes of address space, all inaccessible. NULL on failure.
+static void* reserve_pages(size_t size) {
+#ifdef MAP_ANONYMOUS
+    void* p = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#else
+    int fd = open("/dev/zero", O_RDWR);
+    void* p = fd < 0 ? MAP_FAILED : mmap(NULL, size, PROT_NONE, MAP_PRIVATE, fd, 0);
+    if (fd >= 0) close(fd);
+#endif
+    return p == MAP_FAILED ? NULL : p;
+}
+
+// A dictionary window with its first dict_size bytes (rounded up to
+// whole pages) usable, NULL if out of memory
+static uint8_t* sandbox_dict(int dict_size) {
+    uint8_t* p = reserve_pages(sandbox_window());
+    if (p && mprotect(p, page_round((size_t)dict_size), PROT_READ | PROT_WRITE) != 0) {
+        munmap(p, sandbox_window());
+        p = NULL;
+    }
+    return p;
+}
+
+// A context's stacks: guard, data stack, guard, return stack, guard
+static inline uint8_t* stack_map(const forth_ctx_t* ctx) {
+    return (uint8_t*)ctx->ds - page_round(1);
+}
+
+static inline size_t stack_map_bytes(const forth_ctx_t* ctx) {
+    return 3 * page_round(1) + (size_t)(ctx->ds_size + ctx->rs_size) * sizeof(cell_t);
+}
+
+// Faults in a window, or in the stacks of the running task ring, end
+// the innermost guarded execute() on the thread
+typedef struct forth_fault {
+    sigjmp_buf jmp;
+    const uint8_t* lo;      // The window
+    const uint8_t* hi;
+    forth_ctx_t* entry;
+    struct forth_fault* prev;
+} forth_fault_t;
+
+static _Thread_local forth_fault_t* fault_frame;
+// Whose stacks faulted, set just before the jump: the frame itself is
+// a local of execute_guarded(), indeterminate after siglongjmp
+static _Thread_local forth_ctx_t* fault_ctx;
+static struct sigaction fault_prev;
+
+static void on_fault(int sig, siginfo_t* info, void* uc) {
+    const uint8_t* at = info->si_addr;
+    forth_fault_t* f = fault_frame;
+    if (f && at >= f->lo && at < f->hi) siglongjmp(f->jmp, FF_FAULT);
+    forth_ctx_t* c = f ? f->entry : NULL;
+    do {
+        if (c && c->ds && at >= stack_map(c) && at < stack_map(c) + stack_map_bytes(c)) {
+            fault_ctx = c;
+            siglongjmp(f->jmp, FF_STACK_FAULT);
+        }
+    } while (c && (c = c->next) != f->entry);
+    // Not a VM access: chain to the previous handler, staying installed.
+    // With none, restore the default action so the retry ends the process.
+    if (fault_prev.sa_flags & SA_SIGINFO) {
+        fault_prev.sa_sigaction(sig, info, uc);
+    } else if (fault_prev.sa_handler != SIG_DFL && fault_prev.sa_handler != SIG_IGN) {
+        fault_prev.sa_handler(sig);
+    } else {
+        signal(sig, SIG_DFL);
+    }
+}
+
+static void sandbox_install(void) {
+    struct sigaction sa;
+    sigaction(SIGSEGV, NULL, &sa);
+    if ((sa.sa_flags & SA_SIGINFO) && sa.sa_sigaction == on_fault) return;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = on_fault;
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;   // Left by siglongjmp
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, &fault_prev);
+}
+#endif
+
+// Allocate an empty image: the dictionary (with its dirty bitmap) and
+// the word table are separate segments. 0 if out of memory.
+// Sandboxed, the dictionary is a window and the bitmap covers all of it.
+static int init_image(forth_image_t* img, int dict_size, int max_words) {
+    memset(img, 0, sizeof(*img));
+#ifdef FF_ENABLE_SANDBOX
+    sandbox_install();
+    img->dict = sandbox_dict(dict_size);
+    img->dirty = calloc(dirty_words(FF_SANDBOX_SPAN), sizeof(uint64_t));
+    img->words = alloc_segment((size_t)max_words * sizeof(word_t));
+    if (!img->dict || !img->dirty || !img->words) {
+        if (img->dict) munmap(img->dict, sandbox_window());
+        free(img->dirty);
+        free(img->words);
+        img->dict = NULL;
+        img->dirty = NULL;
+        img->words = NULL;
+        return 0;
+    }
+#else
+    size_t dict_bytes = line_round((size_t)dict_size);
+    img->dict = alloc_segment(dict_bytes + dirty_words(dict_size) * sizeof(uint64_t));
+    img->words = alloc_segment((size_t)max_words * sizeof(word_t));
+    if (!img->dict || !img->words) {
+        free(img->dict);
+        free(img->words);
+        img->dict = NULL;
+        img->words = NULL;
+        return 0;
+    }
+    img->dirty = (uint64_t*)(img->dict + dict_bytes);
+#endif
+    img->dict_size = dict_size;
+    img->max_words = max_words;
+    return 1;
+}
+
+static void free_image(forth_image_t* img) {
+#ifdef FF_ENABLE_FORK
+    if (img->mapped) {
+        munmap(img->dict, img->mapped);
+        img->dict = NULL;
+        img->words = NULL;
+        img->mapped = 0;
+    }
+#endif
+#ifdef FF_ENABLE_SANDBOX
+    if (img->dict) munmap(img->dict, sandbox_window());
+    free(img->dirty);
+#else
+    free(img->dict);
+#endif
+    free(img->words);
+    free(img->calls);
+    img->dict = NULL;
+    img->words = NULL;
+    img->dirty = NULL;
+    img->calls = NULL;
+}
+
+// Copy src into dst's segments, which must have the same sizes. dst
+// keeps its own profile (if any); src's call counts are not copied.
+static void copy_image(forth_image_t* dst, const forth_image_t* src) {
+    uint8_t* dict = dst->dict;
+    word_t* words = dst->words;
+    uint64_t* dirty = dst->dirty;
+    uint32_t* calls = dst->calls;
+    size_t mapped = dst->mapped;
+    memcpy(dict, src->dict, (size_t)src->dict_size);
+    memcpy(dirty, src->dirty, dirty_words(src->dict_size) * sizeof(uint64_t));
+    memcpy(words, src->words, (size_t)src->word_count * sizeof(word_t));
+    *dst = *src;
+    dst->dict = dict;
+    dst->words = words;
+    dst->dirty = dirty;
+    dst->calls = calls;
+    dst->mapped = mapped;
+}
+
+// Give ctx stacks of the given depths: one segment, the return stack
+// starting on its own cache line. 0 if out of memory.
+static int alloc_stacks(forth_ctx_t* ctx, int ds_size, int rs_size) {
+#ifdef FF_ENABLE_SANDBOX
+    // Depths round up to whole pages: pages never touched cost nothing
+    size_t page = page_round(1);
+    size_t ds_bytes = page_round((size_t)ds_size * sizeof(cell_t));
+    size_t rs_bytes = page_round((size_t)rs_size * sizeof(cell_t));
+    uint8_t* map = reserve_pages(3 * page + ds_bytes + rs_bytes);
+    if (map && (mprotect(map + page, ds_bytes, PROT_READ | PROT_WRITE) != 0 ||
+                mprotect(map + 2 * page + ds_bytes, rs_bytes, PROT_READ | PROT_WRITE) != 0)) {
+        munmap(map, 3 * page + ds_bytes + rs_bytes);
+        map = NULL;
+    }
+    ctx->ds = map ? (cell_t*)(map + page) : NULL;
+    ctx->rs = map ? (cell_t*)(map + 2 * page + ds_bytes) : NULL;
+    ctx->ds_size = map ? (int)(ds_bytes / sizeof(cell_t)) : 0;
+    ctx->rs_size = map ? (int)(rs_bytes / sizeof(cell_t)) : 0;
+    return map != NULL;
+#else
+    size_t ds_bytes = line_round((size_t)ds_size * sizeof(cell_t));
+    cell_t* ds = alloc_segment(ds_bytes + (size_t)rs_size * sizeof(cell_t));
+    ctx->ds = ds;
+    ctx->rs = ds ? (cell_t*)((uint8_t*)ds + ds_bytes) : NULL;
+    ctx->ds_size = ds ? ds_size : 0;
+    ctx->rs_size = ds ? rs_size : 0;
+    return ds != NULL;
+#endif
+}
+
+#ifdef FF_ENABLE_THREADS
+#ifndef FF_POOL_MAX_THREADS
+#define FF_POOL_MAX_THREADS 64
+#endif
+#define FF_PAR_MAX_SLICES FF_POOL_MAX_THREADS
+#else
+#define FF_PAR_MAX_SLICES 1
+#endif
+
+// A PAR-DO slice: suspended on a context of its own, or done with its
+// result in acc
+typedef struct {
+    forth_ctx_t* ctx;
+    cell_t acc;
+    int done;
+} forth_par_slice_t;
+
+typedef struct forth_par_parked {
+    addr_t at;          // The PAR-DO instruction
+    int nslices;
+    forth_par_slice_t slices[FF_PAR_MAX_SLICES];
+} forth_par_parked_t;
+
+static void par_drop(forth_par_parked_t* par);
+
+// Forget a suspended PAR-DO: the context starts over
+static void par_discard(forth_ctx_t* ctx) {
+    if (!ctx->par) return;
+    par_drop(ctx->par);
+    free(ctx->par);
+    ctx->par = NULL;
+}
+
+// Release a context's stacks and heap
+static void free_ctx(forth_ctx_t* ctx) {
+    par_discard(ctx);
+#ifdef FF_ENABLE_SANDBOX
+    if (ctx->ds) munmap(stack_map(ctx), stack_map_bytes(ctx));
+#else
+    free(ctx->ds);
+#endif
+    ctx->ds = ctx->rs = NULL;
+    ctx->ds_size = ctx->rs_size = 0;
+    free_heap(ctx->heap);
+    ctx->heap = NULL;
+}
+
+// Free the contexts of a PAR-DO's suspended slices
+static void par_drop(forth_par_parked_t* par) {
+    for (int i = 0; i < par->nslices; i++) {
+        if (par->slices[i].ctx) {
+            free_ctx(par->slices[i].ctx);
+            free(par->slices[i].ctx);
+            par->slices[i].ctx = NULL;
+        }
+    }
+}
+
+// The context's heap, created if needed. NULL if out of memory.
+static inline forth_heap_t* ctx_heap(forth_ctx_t* ctx) {
+    if (!ctx->heap) ctx->heap = calloc(1, sizeof(forth_heap_t));
+    return ctx->heap;
+}
+
+// Initialize an execution context (empty stacks of the given depths,
+// default I/O). 0 if out of memory; free_ctx() releases the stacks.
+static int init_ctx_sized(forth_ctx_t* ctx, int ds_size, int rs_size) {
+    memset(ctx, 0, sizeof(*ctx));
+    if (!alloc_stacks(ctx, ds_size, rs_size)) return 0;
+    
+    // Setup default I/O callbacks
+    ctx->io.getchar_fn = getchar;
+    ctx->io.putchar_fn = default_putchar;
+    ctx->io.flush_fn = default_flush;
+    ctx->io.fopen_fn = fopen;
+    ctx->io.fclose_fn = fclose;
+    ctx->io.fgets_fn = fgets;
+    ctx->io.fputs_fn = fputs;
+    ctx->next = ctx;
+    ctx->current = ctx;
+    ctx->fuel = FF_FUEL_UNLIMITED;
+    return 1;
+}
+
+// A context with the default stack depths
+static int init_ctx(forth_ctx_t* ctx) {
+    return init_ctx_sized(ctx, FF_STACK_DEPTH, FF_RET_DEPTH);
+}
+
+// PAR-DO reductions, combining the per-worker results of a parallel loop
+typedef enum {
+    PAR_ADD = 0,    // +
+    PAR_MAX,        // MAX
+    PAR_MIN,        // MIN
+    PAR_AND,        // AND
+    PAR_OR          // OR
+} par_reduce_t;
+
+static int par_loop(forth_image_t* img, forth_ctx_t* ctx, volatile sig_atomic_t* interrupt,
+                    addr_t at, uint8_t kind, cell_t* acc, cell_t lo, cell_t hi, int64_t* fuel);
+
+#ifdef FF_ENABLE_THREADS
+static inline forth_channel_t* channel_at(forth_image_t* img, cell_t n) {
+    return n >= 1 && n <= img->channel_count ? img->channels[n - 1] : NULL;
+}
+
+// Make a host channel visible to Forth as a word pushing its number
+static inline int bind_channel(forth_image_t* img, const char* name, forth_channel_t* ch) {
+    if (img->channel_count >= FF_MAX_CHANNELS) return 0;
+    // The word first: on failure nothing refers to ch
+    addr_t word_addr = img->here;
+    if (!emit_byte(img, OP_LIT) || !emit_cell(img, img->channel_count + 1) ||
+        !emit_byte(img, OP_EXIT) || !add_word(img, name, word_addr)) {
+        img->here = word_addr;
+        return 0;
+    }
+    img->words[img->word_count - 1].flags |= FF_WORD_CHANNEL;
+    img->channels[img->channel_count++] = ch;
+    return 1;
+}
+#endif
+
+#ifdef FF_ENABLE_SANDBOX
+// In the interpreter the guard pages check the data stack
+#undef PUSH
+#undef POP
+#define PUSH(ctx, val) ((ctx)->ds[(ctx)->sp++] = (val))
+#define POP(ctx) ((ctx)->ds[--(ctx)->sp])
+#endif
+
+// THE HEART: Fast interpreter with switch dispatch
+// This is the secret sauce - inline everything, let compiler optimize
+// Only ctx is written (plus the dictionary for ! into it, ALLOT),
+// so many contexts may run words from one image at the same time.
+// PAUSE hands the CPU to the next task in ctx's ring; we return once
+// the word started on the entry context finishes, or at a safepoint
+// when the entry context runs out of fuel or is interrupted.
+#ifdef FF_NO_SAFEPOINTS
+#define SAFEPOINT(at) ((void)0)
+#else
+#define SAFEPOINT(at) do { \
+        if (--fuel < 0 || *interrupt) { pc = (at); goto suspend; } \
+    } while (0)
+#endif
+
+static inline int execute_from(forth_image_t* img, forth_ctx_t* entry,
+                               forth_ctx_t* ctx, addr_t pc) {
+    int64_t fuel = entry->fuel;
+    volatile sig_atomic_t* interrupt = entry->interrupt_at ? entry->interrupt_at : &entry->interrupt;
+    int status = FF_OK;
+    while (1) {
+        uint8_t op = img->dict[pc++];
+        switch (op) {
+            case OP_EXIT:
+                if (ctx->rp == 0) {
+                    if (ctx == entry) goto done;  // Exit interpreter
+                    // A task's word finished: unlink it and move on
+                    forth_ctx_t* prev = ctx;
+                    while (prev->next != ctx) prev = prev->next;
+                    prev->next = ctx->next;
+                    ctx->next = ctx;
+                    ctx = prev->next;
+                    pc = ctx->pc;
+                    break;
+                }
+                pc = ctx->rs[--ctx->rp];    // Return from word
+                break;
+                
+            case OP_LIT: {
+                cell_t val = read_cell(img, &pc);
+                PUSH(ctx, val);
+                break;
+            }
+            
+            case OP_CALL: {
+                SAFEPOINT(pc - 1);
+                addr_t addr = read_addr(img, &pc);
+                if (img->calls && addr < img->dict_size) ATOMIC_ADD(&img->calls[addr], 1);
+                ctx->rs[ctx->rp++] = pc;    // Save return address
+                pc = addr;                 // Jump to word
+                break;
+            }
+            
+            case OP_ADD: {
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a + b);
+                break;
+            }
+            
+            case OP_SUB: {
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a - b);
+                break;
+            }
+            
+            case OP_MUL: {
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a * b);
+                break;
+            }
+            
+            case OP_DIV: {
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, b ? a / b : 0);
+                break;
+            }
+            
+            case OP_DUP: {
+                if (ctx->sp > 0) {
+                    PUSH(ctx, TOS(ctx));
+                }
                 break;
             }
             
             case OP_DROP: {
-                if (vm->sp > 0) vm->sp--;
+                if (ctx->sp > 0) ctx->sp--;
                 break;
             }
             
             case OP_SWAP: {
-                if (vm->sp >= 2) {
-                    cell_t tmp = TOS(vm);
-                    TOS(vm) = NOS(vm);
-                    NOS(vm) = tmp;
+                if (ctx->sp >= 2) {
+                    cell_t tmp = TOS(ctx);
+                    TOS(ctx) = NOS(ctx);
+                    NOS(ctx) = tmp;
                 }
                 break;
             }
             
             case OP_OVER: {
-                if (vm->sp >= 2) {
-                    PUSH(vm, NOS(vm));
+                if (ctx->sp >= 2) {
+                    PUSH(ctx, NOS(ctx));
                 }
                 break;
             }
             
             case OP_DOT: {
-                if (vm->sp > 0) {
-                    printf("%d ", (int)POP(vm));
-                    fflush(stdout);
+                if (ctx->sp > 0) {
+                    char buf[24];
+                    snprintf(buf, sizeof(buf), "%lld ", (long long)POP(ctx));
+                    io_print(ctx, buf);
                 }
                 break;
             }
             case OP_AND: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a & b);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a & b);
                 break;
             }
             case OP_OR: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a | b);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a | b);
                 break;
             }
             case OP_XOR: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a ^ b);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a ^ b);
                 break;
             }
             case OP_NOT: {
-                cell_t a = POP(vm);
-                PUSH(vm, ~a);
+                cell_t a = POP(ctx);
+                PUSH(ctx, ~a);
                 break;
             }
             case OP_LT: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a < b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a < b ? -1 : 0);
                 break;
             }
             case OP_GT: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a > b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a > b ? -1 : 0);
                 break;
             }
             case OP_EQ: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a == b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a == b ? -1 : 0);
                 break;
             }
             case OP_LE: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a <= b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a <= b ? -1 : 0);
                 break;
             }
             case OP_GE: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a >= b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a >= b ? -1 : 0);
                 break;
             }
             case OP_NE: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a != b ? -1 : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a != b ? -1 : 0);
                 break;
             }
             case OP_BRANCH: {
-                addr_t target = read_addr(vm, &pc);
+                addr_t target = read_addr(img, &pc);
+                if (target < pc) SAFEPOINT(pc - 3);
                 pc = target;
                 break;
             }
             case OP_BRANCH_IF_ZERO: {
-                addr_t target = read_addr(vm, &pc);
-                cell_t cond = POP(vm);
+                addr_t target = read_addr(img, &pc);
+                if (target < pc) SAFEPOINT(pc - 3);
+                cell_t cond = POP(ctx);
                 if (cond == 0) pc = target;
                 break;
             }
             case OP_DO: {
                 // (limit index -- ) R: ( -- limit index)
-                cell_t index = POP(vm);
-                cell_t limit = POP(vm);
-                vm->rs[vm->rp++] = limit;
-                vm->rs[vm->rp++] = index;
+                cell_t index = POP(ctx);
+                cell_t limit = POP(ctx);
+                ctx->rs[ctx->rp++] = limit;
+                ctx->rs[ctx->rp++] = index;
                 break;
             }
             case OP_LOOP: {
-                addr_t loop_addr = read_addr(vm, &pc);
-                cell_t index = vm->rs[vm->rp - 1] + 1;  // Index is at rp-1
-                cell_t limit = vm->rs[vm->rp - 2];       // Limit is at rp-2
+                SAFEPOINT(pc - 1);
+                addr_t loop_addr = read_addr(img, &pc);
+                cell_t index = ctx->rs[ctx->rp - 1] + 1;  // Index is at rp-1
+                cell_t limit = ctx->rs[ctx->rp - 2];       // Limit is at rp-2
                 if (index < limit) {
-                    vm->rs[vm->rp - 1] = index;  // Update index
+                    ctx->rs[ctx->rp - 1] = index;  // Update index
                     pc = loop_addr;
                 } else {
-                    vm->rp -= 2;  // Pop both limit and index
+                    ctx->rp -= 2;  // Pop both limit and index
                 }
                 break;
             }
             case OP_I: {
                 // Push current loop index
-                if (vm->rp >= 2) {
-                    PUSH(vm, vm->rs[vm->rp - 1]);
+                if (ctx->rp >= 2) {
+                    PUSH(ctx, ctx->rs[ctx->rp - 1]);
                 }
                 break;
             }
             case OP_LOAD: {
-                cell_t addr = POP(vm);
-                if (addr >= 0 && addr + sizeof(cell_t) <= FF_DICT_SIZE) {
-                    cell_t val = 0;
-                    for (size_t i = 0; i < sizeof(cell_t); i++) {
-                        val |= ((cell_t)vm->dict[addr + i]) << (i * 8);
-                    }
-                    PUSH(vm, val);
-                } else {
-                    PUSH(vm, 0);
-                }
+                cell_t addr = POP(ctx);
+                const uint8_t* m = dict_cell(img, addr) ? &img->dict[addr] :
+                                   mem_at(img, ctx, addr, sizeof(cell_t));
+                PUSH(ctx, m ? load_cell(m) : 0);
                 break;
             }
             case OP_STORE: {
-                cell_t addr = POP(vm);
-                cell_t val = POP(vm);
-                if (addr >= 0 && addr + sizeof(cell_t) <= FF_DICT_SIZE) {
-                    for (size_t i = 0; i < sizeof(cell_t); i++) {
-                        vm->dict[addr + i] = (val >> (i * 8)) & 0xFF;
-                    }
+                cell_t addr = POP(ctx);
+                cell_t val = POP(ctx);
+                uint8_t* m;
+                if (dict_cell(img, addr)) {
+                    mark_page(img, addr);
+                    m = &img->dict[addr];
+                } else {
+                    m = mem_store_at(img, ctx, addr, sizeof(cell_t));
                 }
+                if (m) store_cell(m, val);
                 break;
             }
             case OP_LOAD_BYTE: {
-                cell_t addr = POP(vm);
-                if (addr >= 0 && addr < FF_DICT_SIZE) {
-                    PUSH(vm, vm->dict[addr]);
-                } else {
-                    PUSH(vm, 0);
-                }
+                cell_t addr = POP(ctx);
+                const uint8_t* m = dict_byte(img, addr) ? &img->dict[addr] :
+                                   mem_at(img, ctx, addr, 1);
+                PUSH(ctx, m ? *m : 0);
                 break;
             }
             case OP_STORE_BYTE: {
-                cell_t addr = POP(vm);
-                cell_t val = POP(vm);
-                if (addr >= 0 && addr < FF_DICT_SIZE) {
-                    vm->dict[addr] = val & 0xFF;
+                cell_t addr = POP(ctx);
+                cell_t val = POP(ctx);
+                uint8_t* m;
+                if (dict_byte(img, addr)) {
+                    mark_page(img, addr);
+                    m = &img->dict[addr];
+                } else {
+                    m = mem_store_at(img, ctx, addr, 1);
                 }
+                if (m) *m = val & 0xFF;
                 break;
             }
             
             // Stack ops extended
             case OP_ROT: {
                 // ( a b c -- b c a )
-                if (vm->sp >= 3) {
-                    cell_t c = vm->ds[vm->sp - 1];
-                    cell_t b = vm->ds[vm->sp - 2];
-                    cell_t a = vm->ds[vm->sp - 3];
-                    vm->ds[vm->sp - 3] = b;
-                    vm->ds[vm->sp - 2] = c;
-                    vm->ds[vm->sp - 1] = a;
+                if (ctx->sp >= 3) {
+                    cell_t c = ctx->ds[ctx->sp - 1];
+                    cell_t b = ctx->ds[ctx->sp - 2];
+                    cell_t a = ctx->ds[ctx->sp - 3];
+                    ctx->ds[ctx->sp - 3] = b;
+                    ctx->ds[ctx->sp - 2] = c;
+                    ctx->ds[ctx->sp - 1] = a;
                 }
                 break;
             }
             case OP_2DUP: {
                 // ( a b -- a b a b )
-                if (vm->sp >= 2) {
-                    cell_t b = vm->ds[vm->sp - 1];
-                    cell_t a = vm->ds[vm->sp - 2];
-                    PUSH(vm, a);
-                    PUSH(vm, b);
+                if (ctx->sp >= 2) {
+                    cell_t b = ctx->ds[ctx->sp - 1];
+                    cell_t a = ctx->ds[ctx->sp - 2];
+                    PUSH(ctx, a);
+                    PUSH(ctx, b);
                 }
                 break;
             }
             case OP_2DROP: {
                 // ( a b -- )
-                if (vm->sp >= 2) {
-                    vm->sp -= 2;
+                if (ctx->sp >= 2) {
+                    ctx->sp -= 2;
                 }
                 break;
             }
             case OP_NIP: {
                 // ( a b -- b )
-                if (vm->sp >= 2) {
-                    vm->ds[vm->sp - 2] = vm->ds[vm->sp - 1];
-                    vm->sp--;
+                if (ctx->sp >= 2) {
+                    ctx->ds[ctx->sp - 2] = ctx->ds[ctx->sp - 1];
+                    ctx->sp--;
                 }
                 break;
             }
             case OP_TUCK: {
                 // ( a b -- b a b )
-                if (vm->sp >= 2) {
-                    cell_t b = vm->ds[vm->sp - 1];
-                    cell_t a = vm->ds[vm->sp - 2];
-                    vm->ds[vm->sp - 2] = b;
-                    vm->ds[vm->sp - 1] = a;
-                    PUSH(vm, b);
+                if (ctx->sp >= 2) {
+                    cell_t b = ctx->ds[ctx->sp - 1];
+                    cell_t a = ctx->ds[ctx->sp - 2];
+                    ctx->ds[ctx->sp - 2] = b;
+                    ctx->ds[ctx->sp - 1] = a;
+                    PUSH(ctx, b);
                 }
                 break;
             }
@@ -518,104 +1821,104 @@ static inline void execute(forth_t* vm, addr_t start) {
             // Return stack
             case OP_TO_R: {
                 // >R ( n -- ) R: ( -- n )
-                cell_t val = POP(vm);
-                if (vm->rp < FF_RET_DEPTH) {
-                    vm->rs[vm->rp++] = val;
+                cell_t val = POP(ctx);
+                if (ctx->rp < ctx->rs_size) {
+                    ctx->rs[ctx->rp++] = val;
                 }
                 break;
             }
             case OP_R_FROM: {
                 // R> ( -- n ) R: ( n -- )
-                if (vm->rp > 0) {
-                    PUSH(vm, vm->rs[--vm->rp]);
+                if (ctx->rp > 0) {
+                    PUSH(ctx, ctx->rs[--ctx->rp]);
                 }
                 break;
             }
             case OP_R_FETCH: {
                 // R@ ( -- n ) R: ( n -- n )
-                if (vm->rp > 0) {
-                    PUSH(vm, vm->rs[vm->rp - 1]);
+                if (ctx->rp > 0) {
+                    PUSH(ctx, ctx->rs[ctx->rp - 1]);
                 }
                 break;
             }
             
             // Arithmetic extended
             case OP_MOD: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, b ? a % b : 0);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, b ? a % b : 0);
                 break;
             }
             case OP_NEGATE: {
-                cell_t a = POP(vm);
-                PUSH(vm, -a);
+                cell_t a = POP(ctx);
+                PUSH(ctx, -a);
                 break;
             }
             case OP_ABS: {
-                cell_t a = POP(vm);
-                PUSH(vm, a < 0 ? -a : a);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a < 0 ? -a : a);
                 break;
             }
             case OP_MIN: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a < b ? a : b);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a < b ? a : b);
                 break;
             }
             case OP_MAX_OP: {
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
-                PUSH(vm, a > b ? a : b);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a > b ? a : b);
                 break;
             }
             case OP_DIVMOD: {
                 // /MOD ( a b -- rem quot )
-                cell_t b = POP(vm);
-                cell_t a = POP(vm);
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
                 if (b) {
-                    PUSH(vm, a % b);  // remainder
-                    PUSH(vm, a / b);  // quotient
+                    PUSH(ctx, a % b);  // remainder
+                    PUSH(ctx, a / b);  // quotient
                 } else {
-                    PUSH(vm, 0);
-                    PUSH(vm, 0);
+                    PUSH(ctx, 0);
+                    PUSH(ctx, 0);
                 }
                 break;
             }
             case OP_1PLUS: {
-                if (vm->sp > 0) {
-                    TOS(vm)++;
+                if (ctx->sp > 0) {
+                    TOS(ctx)++;
                 }
                 break;
             }
             case OP_1MINUS: {
-                if (vm->sp > 0) {
-                    TOS(vm)--;
+                if (ctx->sp > 0) {
+                    TOS(ctx)--;
                 }
                 break;
             }
             
             // Comparisons extended
             case OP_ZERO_EQ: {
-                cell_t a = POP(vm);
-                PUSH(vm, a == 0 ? -1 : 0);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a == 0 ? -1 : 0);
                 break;
             }
             case OP_ZERO_LT: {
-                cell_t a = POP(vm);
-                PUSH(vm, a < 0 ? -1 : 0);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a < 0 ? -1 : 0);
                 break;
             }
             case OP_ZERO_NE: {
-                cell_t a = POP(vm);
-                PUSH(vm, a != 0 ? -1 : 0);
+                cell_t a = POP(ctx);
+                PUSH(ctx, a != 0 ? -1 : 0);
                 break;
             }
             
             // Stack extended
             case OP_QDUP: {
                 // ?DUP ( n -- n n | 0 )
-                if (vm->sp > 0 && TOS(vm) != 0) {
-                    PUSH(vm, TOS(vm));
+                if (ctx->sp > 0 && TOS(ctx) != 0) {
+                    PUSH(ctx, TOS(ctx));
                 }
                 break;
             }
@@ -623,96 +1926,101 @@ static inline void execute(forth_t* vm, addr_t start) {
             // Memory extended
             case OP_PLUSSTORE: {
                 // +! ( n addr -- )
-                cell_t addr = POP(vm);
-                cell_t val = POP(vm);
-                if (addr >= 0 && addr + sizeof(cell_t) <= FF_DICT_SIZE) {
-                    cell_t old_val = 0;
-                    for (size_t i = 0; i < sizeof(cell_t); i++) {
-                        old_val |= ((cell_t)vm->dict[addr + i]) << (i * 8);
-                    }
-                    cell_t new_val = old_val + val;
-                    for (size_t i = 0; i < sizeof(cell_t); i++) {
-                        vm->dict[addr + i] = (new_val >> (i * 8)) & 0xFF;
-                    }
+                cell_t addr = POP(ctx);
+                cell_t val = POP(ctx);
+                uint8_t* m;
+                if (dict_cell(img, addr)) {
+                    mark_page(img, addr);
+                    m = &img->dict[addr];
+                } else {
+                    m = mem_store_at(img, ctx, addr, sizeof(cell_t));
                 }
+                if (m) store_cell(m, load_cell(m) + val);
                 break;
             }
             case OP_ALLOT: {
                 // ALLOT ( n -- ) allocate n bytes in dictionary
-                cell_t n = POP(vm);
-                if (n > 0 && vm->here + n <= FF_DICT_SIZE) {
-                    vm->here += n;
+                cell_t n = POP(ctx);
+                if (n > 0 && img->here + n <= img->dict_size) {
+                    img->here += n;
                 }
                 break;
             }
             
             // I/O
             case OP_EMIT: {
-                cell_t c = POP(vm);
-                if (vm->io.putchar_fn) {
-                    vm->io.putchar_fn((int)c);
-                    if (vm->io.flush_fn) vm->io.flush_fn();
+                cell_t c = POP(ctx);
+                if (ctx->io.putchar_fn) {
+                    ctx->io.putchar_fn((int)c);
+                    if (ctx->io.flush_fn) ctx->io.flush_fn();
                 }
                 break;
             }
             case OP_KEY: {
-                int c = vm->io.getchar_fn ? vm->io.getchar_fn() : -1;
-                PUSH(vm, c);
+                if (ctx->io.key_ready_fn && (ctx->next != ctx || entry->no_block) &&
+                    !ctx->io.key_ready_fn()) {
+                    pc--;  // No input yet: let the other tasks (or the host) run, then retry
+                    if (ctx->next != ctx) goto pause;
+                    goto blocked;
+                }
+                int c = ctx->io.getchar_fn ? ctx->io.getchar_fn() : -1;
+                PUSH(ctx, c);
                 break;
             }
             case OP_CR: {
-                if (vm->io.putchar_fn) {
-                    vm->io.putchar_fn('\n');
-                    if (vm->io.flush_fn) vm->io.flush_fn();
+                if (ctx->io.putchar_fn) {
+                    ctx->io.putchar_fn('\n');
+                    if (ctx->io.flush_fn) ctx->io.flush_fn();
                 }
                 break;
             }
             case OP_TYPE: {
                 // TYPE ( addr len -- ) print string
-                cell_t len = POP(vm);
-                cell_t addr = POP(vm);
-                if (addr >= 0 && addr + len <= FF_DICT_SIZE && vm->io.putchar_fn) {
+                cell_t len = POP(ctx);
+                cell_t addr = POP(ctx);
+                uint8_t* m = mem_at(img, ctx, addr, len);
+                if (m && ctx->io.putchar_fn) {
                     for (cell_t i = 0; i < len; i++) {
-                        vm->io.putchar_fn(vm->dict[addr + i]);
+                        ctx->io.putchar_fn(m[i]);
                     }
-                    if (vm->io.flush_fn) vm->io.flush_fn();
+                    if (ctx->io.flush_fn) ctx->io.flush_fn();
                 }
                 break;
             }
             
             // Memory info
             case OP_HERE: {
-                PUSH(vm, vm->here);
+                PUSH(ctx, img->here);
                 break;
             }
             
             // Debug/Introspection
             case OP_DOT_S: {
                 // .S ( -- ) show stack non-destructively
-                printf("<");
-                printf("%d", vm->sp);
-                printf("> ");
-                for (int i = 0; i < vm->sp; i++) {
-                    printf("%d ", (int)vm->ds[i]);
+                char buf[24];
+                snprintf(buf, sizeof(buf), "<%d> ", ctx->sp);
+                io_print(ctx, buf);
+                for (int i = 0; i < ctx->sp; i++) {
+                    snprintf(buf, sizeof(buf), "%lld ", (long long)ctx->ds[i]);
+                    io_print(ctx, buf);
                 }
-                fflush(stdout);
                 break;
             }
             case OP_DEPTH: {
-                PUSH(vm, vm->sp);
+                PUSH(ctx, ctx->sp);
                 break;
             }
             case OP_CLEAR: {
-                vm->sp = 0;
+                ctx->sp = 0;
                 break;
             }
             case OP_WORDS: {
-                printf("Words: ");
-                for (int i = 0; i < vm->word_count; i++) {
-                    printf("%s ", vm->words[i].name);
+                io_print(ctx, "Words: ");
+                for (int i = 0; i < img->word_count; i++) {
+                    io_print(ctx, img->words[i].name);
+                    io_print(ctx, " ");
                 }
-                printf("\n");
-                fflush(stdout);
+                io_print(ctx, "\n");
                 break;
             }
             case OP_SEE: {
@@ -721,32 +2029,1442 @@ static inline void execute(forth_t* vm, addr_t start) {
                 break;
             }
             
+            // Multitasking
+            case OP_PAUSE: {
+            pause:
+                // Round-robin: park this task, resume the next one
+                ctx->pc = pc;
+                ctx = ctx->next;
+                pc = ctx->pc;
+                break;
+            }
+            case OP_KEYQ: {
+                int ready = ctx->io.key_ready_fn ? ctx->io.key_ready_fn() : 1;
+                PUSH(ctx, ready ? -1 : 0);
+                break;
+            }
+            
+            // Atomics
+            case OP_ATOMIC_LOAD: {
+                cell_t* c = cell_at(img, ctx, POP(ctx));
+                PUSH(ctx, c ? ATOMIC_LOAD(c) : 0);
+                break;
+            }
+            case OP_ATOMIC_STORE: {
+                cell_t* c = cell_store_at(img, ctx, POP(ctx));
+                cell_t val = POP(ctx);
+                if (c) ATOMIC_STORE(c, val);
+                break;
+            }
+            case OP_ATOMIC_ADD: {
+                cell_t* c = cell_store_at(img, ctx, POP(ctx));
+                cell_t val = POP(ctx);
+                if (c) ATOMIC_ADD(c, val);
+                break;
+            }
+            case OP_CAS: {
+                // CAS ( old new addr -- flag ) store new if the cell holds old
+                cell_t* c = cell_store_at(img, ctx, POP(ctx));
+                cell_t val = POP(ctx);
+                cell_t old = POP(ctx);
+                PUSH(ctx, c && ATOMIC_CAS(c, &old, val) ? -1 : 0);
+                break;
+            }
+            case OP_FENCE: {
+                ATOMIC_FENCE();
+                break;
+            }
+            
+            // Heap: ior is 0 on success, else the standard throw code
+            case OP_ALLOCATE: {
+                cell_t n = POP(ctx);
+                // Not in a PAR-DO slice: the heap is the caller's and not
+                // thread-safe (a slice has no heap, so FREE and RESIZE fail)
+                uint32_t off = n >= 0 && n <= FF_HEAP_MAX && !ctx->parent ?
+                    heap_alloc(ctx_heap(ctx), (uint32_t)n) : 0;
+                PUSH(ctx, off ? FF_HEAP_BASE + (cell_t)off : 0);
+                PUSH(ctx, off ? 0 : -59);
+                break;
+            }
+            case OP_FREE: {
+                cell_t a = POP(ctx);
+                int ok = a >= FF_HEAP_BASE && a - FF_HEAP_BASE < FF_HEAP_MAX &&
+                         heap_free(ctx->heap, (uint32_t)(a - FF_HEAP_BASE));
+                PUSH(ctx, ok ? 0 : -60);
+                break;
+            }
+            case OP_RESIZE: {
+                cell_t n = POP(ctx);
+                cell_t a = POP(ctx);
+                uint32_t off = a >= FF_HEAP_BASE && a - FF_HEAP_BASE < FF_HEAP_MAX &&
+                               n >= 0 && n <= FF_HEAP_MAX ?
+                    heap_resize(ctx->heap, (uint32_t)(a - FF_HEAP_BASE), (uint32_t)n) : 0;
+                PUSH(ctx, off ? FF_HEAP_BASE + (cell_t)off : a);
+                PUSH(ctx, off ? 0 : -61);
+                break;
+            }
+            
+            // Cells and alignment
+            case OP_CELLS: {
+                if (ctx->sp > 0) TOS(ctx) *= (cell_t)sizeof(cell_t);
+                break;
+            }
+            case OP_CELL_PLUS: {
+                if (ctx->sp > 0) TOS(ctx) += (cell_t)sizeof(cell_t);
+                break;
+            }
+            case OP_ALIGNED: {
+                cell_t mask = (cell_t)sizeof(cell_t) - 1;
+                if (ctx->sp > 0) TOS(ctx) = (TOS(ctx) + mask) & ~mask;
+                break;
+            }
+            case OP_ALIGN: {
+                addr_t aligned = (img->here + sizeof(cell_t) - 1) & ~(sizeof(cell_t) - 1);
+                if (aligned <= img->dict_size) img->here = aligned;
+                break;
+            }
+            
+            // Bulk memory: one bounds check per call, then the C library.
+            // A range outside the memory areas (or spanning two) is
+            // ignored, like other out-of-range accesses; COMPARE then
+            // gives -1, never "equal".
+            case OP_MOVE:
+            case OP_CMOVE:
+            case OP_CMOVE_UP: {
+                cell_t n = POP(ctx);
+                cell_t dst = POP(ctx);
+                cell_t src = POP(ctx);
+                if (n <= 0) break;
+                const uint8_t* from = mem_at(img, ctx, src, n);
+                uint8_t* to = from ? mem_store_at(img, ctx, dst, n) : NULL;
+                if (!to) break;
+                // CMOVE into an overlapping range above its source (and
+                // CMOVE> below it) repeats the leading bytes: byte by byte
+                if (op == OP_CMOVE && to > from && to < from + n) {
+                    for (cell_t i = 0; i < n; i++) to[i] = from[i];
+                } else if (op == OP_CMOVE_UP && to < from && to + n > from) {
+                    for (cell_t i = n - 1; i >= 0; i--) to[i] = from[i];
+                } else {
+                    memmove(to, from, (size_t)n);
+                }
+                break;
+            }
+            case OP_FILL: {
+                cell_t c = POP(ctx);
+                cell_t n = POP(ctx);
+                cell_t addr = POP(ctx);
+                uint8_t* m = n > 0 ? mem_store_at(img, ctx, addr, n) : NULL;
+                if (m) memset(m, c & 0xFF, (size_t)n);
+                break;
+            }
+            case OP_ERASE: {
+                cell_t n = POP(ctx);
+                cell_t addr = POP(ctx);
+                uint8_t* m = n > 0 ? mem_store_at(img, ctx, addr, n) : NULL;
+                if (m) memset(m, 0, (size_t)n);
+                break;
+            }
+            case OP_COMPARE: {
+                cell_t n2 = POP(ctx);
+                cell_t a2 = POP(ctx);
+                cell_t n1 = POP(ctx);
+                cell_t a1 = POP(ctx);
+                const uint8_t* m1 = mem_at(img, ctx, a1, n1);
+                const uint8_t* m2 = mem_at(img, ctx, a2, n2);
+                int r = -1;
+                if (m1 && m2) {
+                    r = memcmp(m1, m2, (size_t)(n1 < n2 ? n1 : n2));
+                    if (r == 0) r = (n1 > n2) - (n1 < n2);
+                }
+                PUSH(ctx, (r > 0) - (r < 0));
+                break;
+            }
+            
+            // Double cells. A zero divisor gives 0 0, like / and /MOD;
+            // a quotient too wide for a cell is truncated.
+            case OP_MSTAR: {
+                cell_t b = POP(ctx);
+                cell_t a = POP(ctx);
+                dcell_t d = (dcell_t)a * b;
+                PUSH(ctx, (cell_t)d);
+                PUSH(ctx, double_hi(d));
+                break;
+            }
+            case OP_UMSTAR: {
+                ucell_t b = (ucell_t)POP(ctx);
+                ucell_t a = (ucell_t)POP(ctx);
+                udcell_t d = (udcell_t)a * b;
+                PUSH(ctx, (cell_t)d);
+                PUSH(ctx, double_hi((dcell_t)d));
+                break;
+            }
+            case OP_UMSLASHMOD: {
+                ucell_t u = (ucell_t)POP(ctx);
+                cell_t hi = POP(ctx);
+                cell_t lo = POP(ctx);
+                udcell_t ud = (udcell_t)make_double(lo, hi);
+                PUSH(ctx, u ? (cell_t)(ud % u) : 0);
+                PUSH(ctx, u ? (cell_t)(ud / u) : 0);
+                break;
+            }
+            case OP_SMSLASHREM: {
+                cell_t n = POP(ctx);
+                cell_t hi = POP(ctx);
+                cell_t lo = POP(ctx);
+                dcell_t d = make_double(lo, hi);
+                // -1 separately: the smallest double has no positive
+                dcell_t q = n == -1 ? (dcell_t)(0 - (udcell_t)d) : n ? d / n : 0;
+                PUSH(ctx, n && n != -1 ? (cell_t)(d % n) : 0);
+                PUSH(ctx, (cell_t)q);
+                break;
+            }
+            case OP_DPLUS:
+            case OP_DMINUS: {
+                cell_t bh = POP(ctx);
+                cell_t bl = POP(ctx);
+                cell_t ah = POP(ctx);
+                cell_t al = POP(ctx);
+                udcell_t a = (udcell_t)make_double(al, ah);
+                udcell_t b = (udcell_t)make_double(bl, bh);
+                dcell_t d = (dcell_t)(op == OP_DPLUS ? a + b : a - b);
+                PUSH(ctx, (cell_t)d);
+                PUSH(ctx, double_hi(d));
+                break;
+            }
+            case OP_DDOT: {
+                cell_t hi = POP(ctx);
+                cell_t lo = POP(ctx);
+                char buf[48];
+                double_str(buf, make_double(lo, hi));
+                io_print(ctx, buf);
+                break;
+            }
+            
+            // Bignums
+            case OP_BIG_INIT: {
+                cell_t a = POP(ctx);
+                cell_t cap = POP(ctx);
+                big_init(img, ctx, a, cap);
+                break;
+            }
+            case OP_BIG_STORE: {
+                ucell_t* h = big_at(img, ctx, POP(ctx), 1);
+                ucell_t u = (ucell_t)POP(ctx);
+                if (h) {
+                    h[1] = 1;
+                    h[2] = u;
+                }
+                break;
+            }
+            case OP_BIG_MULN: {
+                ucell_t u = (ucell_t)POP(ctx);
+                ucell_t* h = big_at(img, ctx, POP(ctx), 1);
+                PUSH(ctx, h ? big_mul_cell(h, u) : FF_BIG_BAD);
+                break;
+            }
+            case OP_BIG_ADD: {
+                const ucell_t* b = big_at(img, ctx, POP(ctx), 0);
+                ucell_t* a = big_at(img, ctx, POP(ctx), 1);
+                PUSH(ctx, a && b ? big_add(a, b) : FF_BIG_BAD);
+                break;
+            }
+            case OP_BIG_MUL: {
+                const ucell_t* b = big_at(img, ctx, POP(ctx), 0);
+                const ucell_t* a = big_at(img, ctx, POP(ctx), 0);
+                ucell_t* d = big_at(img, ctx, POP(ctx), 1);
+                PUSH(ctx, d && a && b ? big_mul(d, a, b) : FF_BIG_BAD);
+                break;
+            }
+            case OP_BIG_DIVN: {
+                ucell_t u = (ucell_t)POP(ctx);
+                ucell_t* h = big_at(img, ctx, POP(ctx), 1);
+                PUSH(ctx, h && u ? (cell_t)big_div_cell(h, u) : 0);
+                PUSH(ctx, !h ? FF_BIG_BAD : !u ? FF_BIG_ZERO : 0);
+                break;
+            }
+            case OP_BIG_COMPARE: {
+                const ucell_t* b = big_at(img, ctx, POP(ctx), 0);
+                const ucell_t* a = big_at(img, ctx, POP(ctx), 0);
+                PUSH(ctx, a && b ? big_compare(a, b) : FF_BIG_BAD);
+                break;
+            }
+            case OP_BIG_TO_STR: {
+                cell_t u = POP(ctx);
+                cell_t dst = POP(ctx);
+                const ucell_t* h = big_at(img, ctx, POP(ctx), 0);
+                size_t len = 0;
+                char* digits = h ? big_decimal(h, &len) : NULL;
+                uint8_t* out = digits && u >= 0 && len <= (size_t)u
+                    ? mem_store_at(img, ctx, dst, (cell_t)len) : NULL;
+                if (out) memcpy(out, digits, len);
+                PUSH(ctx, out ? (cell_t)len : 0);
+                free(digits);
+                break;
+            }
+            case OP_BIG_DOT: {
+                const ucell_t* h = big_at(img, ctx, POP(ctx), 0);
+                size_t len = 0;
+                char* digits = h ? big_decimal(h, &len) : NULL;
+                if (digits) {
+                    io_print(ctx, digits);
+                    io_print(ctx, " ");
+                }
+                free(digits);
+                break;
+            }
+            
+            // Parallel loops
+            case OP_PAR_DO: {
+                // ( acc limit index -- acc' ) body follows, ends at end_addr.
+                // If a slice runs out of fuel, is interrupted or fails, the
+                // operands go back and the context parks at PAR-DO. The
+                // suspended slices stay in ctx->par, so resume() carries
+                // on where each one stopped.
+                addr_t at = pc - 1;
+                uint8_t kind = img->dict[pc++];
+                addr_t end_addr = read_addr(img, &pc);
+                cell_t index = POP(ctx);
+                cell_t limit = POP(ctx);
+                cell_t acc = POP(ctx);
+                cell_t result = acc;
+                status = par_loop(img, ctx, interrupt, at, kind, &result, index, limit, &fuel);
+                if (status != FF_OK) {
+                    PUSH(ctx, acc);
+                    PUSH(ctx, limit);
+                    PUSH(ctx, index);
+                    ctx->pc = at;
+                    entry->current = ctx;
+                    goto done;
+                }
+                PUSH(ctx, result);
+                pc = end_addr;
+                break;
+            }
+            
+#ifdef FF_ENABLE_THREADS
+            // Channels: a blocked SEND/RECV leaves its operands in place,
+            // passes a safepoint and switches to the next task. With no
+            // other task it returns FF_BLOCKED under no_block (step(),
+            // servers); otherwise it spins on sched_yield() and, like an
+            // endless loop, only stops on fuel or interrupt.
+            case OP_SEND: {
+                // SEND ( x ch -- )
+                forth_channel_t* ch = ctx->sp >= 2 ? channel_at(img, TOS(ctx)) : NULL;
+                if (!ch) {
+                    ctx->sp = ctx->sp >= 2 ? ctx->sp - 2 : 0;
+                    break;
+                }
+                if (channel_try_send(ch, NOS(ctx))) {
+                    ctx->channels_used |= (uint64_t)1 << ((TOS(ctx) - 1) & 63);
+                    ctx->sp -= 2;
+                    break;
+                }
+                pc--;
+                SAFEPOINT(pc);
+                if (ctx->next != ctx) goto pause;
+                if (entry->no_block) goto blocked;
+                sched_yield();
+                break;
+            }
+            case OP_RECV: {
+                // RECV ( ch -- x )
+                forth_channel_t* ch = ctx->sp >= 1 ? channel_at(img, TOS(ctx)) : NULL;
+                if (!ch) {
+                    if (ctx->sp > 0) TOS(ctx) = 0;
+                    break;
+                }
+                cell_t n = TOS(ctx);
+                if (channel_try_recv(ch, &TOS(ctx))) {
+                    ctx->channels_used |= (uint64_t)1 << ((n - 1) & 63);
+                    break;
+                }
+                pc--;
+                SAFEPOINT(pc);
+                if (ctx->next != ctx) goto pause;
+                if (entry->no_block) goto blocked;
+                sched_yield();
+                break;
+            }
+            case OP_TRY_RECV: {
+                // TRY-RECV ( ch -- x -1 | 0 )
+                cell_t n = POP(ctx);
+                forth_channel_t* ch = channel_at(img, n);
+                cell_t x;
+                if (ch && channel_try_recv(ch, &x)) {
+                    ctx->channels_used |= (uint64_t)1 << ((n - 1) & 63);
+                    PUSH(ctx, x);
+                    PUSH(ctx, -1);
+                } else {
+                    PUSH(ctx, 0);
+                }
+                break;
+            }
+#endif
+            
             default:
-                fprintf(stderr, "Unknown opcode: %d at pc=%d\n", op, pc - 1);
-                return;
+                io_error(ctx, "Unknown opcode: %d at pc=%d\n", op, pc - 1);
+                status = FF_ERROR;
+                goto done;
         }
     }
+    
+blocked:
+    // Park at the blocking instruction, which runs again on resume
+    ctx->pc = pc;
+    entry->current = ctx;
+    status = FF_BLOCKED;
+    goto done;
+#ifndef FF_NO_SAFEPOINTS
+suspend:
+    // Park the running task exactly at the safepoint instruction
+    ctx->pc = pc;
+    entry->current = ctx;
+    if (fuel < 0) {
+        fuel = 0;
+        status = FF_OUT_OF_FUEL;
+    } else {
+        fuel++;  // The check did not consume
+        status = FF_INTERRUPTED;
+    }
+#endif
+done:
+    entry->fuel = fuel;
+    return status;
 }
 
-// Token parsing
-static const char* next_token(forth_t* vm, const char* in) {
-    while (*in && isspace((unsigned char)*in)) in++;
-    if (!*in) return NULL;
-    
-    char* out = vm->token;
-    size_t len = 0;
-    while (*in && !isspace((unsigned char)*in) && len < FF_NAME_MAX) {
-        *out++ = (char)toupper((unsigned char)*in++);
-        len++;
+#ifdef FF_ENABLE_SANDBOX
+#undef PUSH
+#undef POP
+#define PUSH(ctx, val) do { if ((ctx)->sp < (ctx)->ds_size) (ctx)->ds[(ctx)->sp++] = (val); } while(0)
+#define POP(ctx) ((ctx)->sp > 0 ? (ctx)->ds[--(ctx)->sp] : 0)
+#endif
+
+#ifdef FF_ENABLE_SANDBOX
+// execute_from() with faults in img's window turned into FF_FAULT, and
+// in the tasks' stacks into FF_STACK_FAULT. The faulting task's stack
+// pointers are clamped back into range; callers reset the stacks.
+static int execute_guarded(forth_image_t* img, forth_ctx_t* entry,
+                           forth_ctx_t* ctx, addr_t pc) {
+    forth_fault_t frame;
+    frame.lo = img->dict;
+    frame.hi = img->dict + sandbox_window();
+    frame.entry = entry;
+    frame.prev = fault_frame;
+    fault_ctx = NULL;
+    int fault = sigsetjmp(frame.jmp, 0);
+    if (fault) {
+        fault_frame = frame.prev;
+        forth_ctx_t* c = fault_ctx;
+        fault_ctx = NULL;
+        if (c) {
+            c->sp = c->sp < 0 ? 0 : c->sp > c->ds_size ? c->ds_size : c->sp;
+            c->rp = c->rp < 0 ? 0 : c->rp > c->rs_size ? c->rs_size : c->rp;
+        }
+        return fault;
     }
-    *out = '\0';
-    
-    while (*in && !isspace((unsigned char)*in)) in++;
-    return in;
+    fault_frame = &frame;
+    int status = execute_from(img, entry, ctx, pc);
+    fault_frame = frame.prev;
+    return status;
 }
+#define EXECUTE_FROM execute_guarded
+#else
+#define EXECUTE_FROM execute_from
+#endif
 
-// Interpret a token
-static int interpret_token(forth_t* vm, const char* tok) {
+// Run the word at start on ctx (a suspended PAR-DO is forgotten)
+static inline int execute(forth_image_t* img, forth_ctx_t* ctx, addr_t start) {
+    if (ctx->par) par_discard(ctx);
+    return EXECUTE_FROM(img, ctx, ctx, start);
+}
+
+// Continue after FF_OUT_OF_FUEL, FF_INTERRUPTED or FF_BLOCKED
+static inline int resume(forth_image_t* img, forth_ctx_t* ctx) {
+    forth_ctx_t* cur = ctx->current;
+    ctx->current = ctx;
+    return EXECUTE_FROM(img, ctx, cur, cur->pc);
+}
+
+// Step API for host event loops: step_start() sets up a word without
+// running it; each step() then runs for at most budget safepoints, or
+// until the word would block on input or a channel, and returns the
+// status. All state stays in ctx, so thousands of contexts can be
+// interleaved on one thread. Done when step() returns FF_OK.
+static inline void step_start(forth_ctx_t* ctx, addr_t xt) {
+    par_discard(ctx);
+    ctx->rp = 0;
+    ctx->pc = xt;
+    ctx->current = ctx;
+}
+
+static inline int step(forth_image_t* img, forth_ctx_t* ctx, int64_t budget) {
+    ctx->fuel = budget;
+    ctx->no_block = 1;
+    int status = resume(img, ctx);
+    ctx->no_block = 0;
+    return status;
+}
+
+#ifdef FF_ENABLE_THREADS
+// Thread pool - a fixed set of workers, each running jobs on its own
+// execution context over a shared image. Enable with -DFF_ENABLE_THREADS
+// and link with -pthread.
+#ifndef FF_BATCH_CHUNK
+#define FF_BATCH_CHUNK 16
+#endif
+
+typedef void (*forth_job_fn)(forth_pool_t* pool, int worker, void* arg);
+
+struct forth_pool {
+    pthread_t threads[FF_POOL_MAX_THREADS];
+    int nthreads;
+    
+    // Current job, handed to every worker (fork-join)
+    pthread_mutex_t lock;
+    pthread_cond_t start_cv;
+    pthread_cond_t done_cv;
+    forth_job_fn job;
+    void* job_arg;
+    unsigned generation;    // Bumped for each job
+    int running;            // Workers still inside the current job
+    int shutdown;
+};
+
+typedef struct {
+    forth_pool_t* pool;
+    int id;
+} forth_worker_arg_t;
+
+static void* pool_worker(void* p) {
+    forth_worker_arg_t* wa = p;
+    forth_pool_t* pool = wa->pool;
+    int id = wa->id;
+    free(wa);
+    
+    unsigned seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pthread_cond_wait(&pool->start_cv, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        forth_job_fn job = pool->job;
+        void* arg = pool->job_arg;
+        pthread_mutex_unlock(&pool->lock);
+        
+        job(pool, id, arg);
+        
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Start nthreads workers (0 or less: one per online CPU)
+static inline int init_pool(forth_pool_t* pool, int nthreads) {
+    memset(pool, 0, sizeof(*pool));
+    if (nthreads <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (nthreads <= 0) nthreads = 1;
+    }
+    if (nthreads > FF_POOL_MAX_THREADS) nthreads = FF_POOL_MAX_THREADS;
+    
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    
+    for (int i = 0; i < nthreads; i++) {
+        forth_worker_arg_t* wa = malloc(sizeof(*wa));
+        if (!wa) break;
+        wa->pool = pool;
+        wa->id = i;
+        if (pthread_create(&pool->threads[i], NULL, pool_worker, wa) != 0) {
+            free(wa);
+            break;
+        }
+        pool->nthreads++;
+    }
+    return pool->nthreads > 0;
+}
+
+static inline void free_pool(forth_pool_t* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->nthreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_cond_destroy(&pool->start_cv);
+    pthread_mutex_destroy(&pool->lock);
+    pool->nthreads = 0;
+}
+
+// Run job(pool, worker, arg) once on every worker and wait for all of them.
+// One job at a time: concurrent callers are serialized.
+static inline void pool_run(forth_pool_t* pool, forth_job_fn job, void* arg) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pool->job = job;
+    pool->job_arg = arg;
+    pool->running = pool->nthreads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cv);
+    while (pool->running) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_cond_signal(&pool->done_cv);  // Wake the next queued caller
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Work-stealing index range: [lo, hi) packed in one atomic word so the
+// owner (taking chunks from the front) and thieves (taking the back half)
+// only ever race on a single CAS. Padded to its own cache line.
+typedef struct {
+    _Atomic uint64_t range;
+    char pad[64 - sizeof(uint64_t)];
+} forth_range_t;
+
+#define RANGE_PACK(lo, hi) (((uint64_t)(hi) << 32) | (uint32_t)(lo))
+#define RANGE_LO(r) ((uint32_t)(r))
+#define RANGE_HI(r) ((uint32_t)((r) >> 32))
+
+// Owner side: take up to `chunk` items from the front
+static int range_take(forth_range_t* r, uint32_t chunk, uint32_t* lo, uint32_t* hi) {
+    uint64_t cur = atomic_load_explicit(&r->range, memory_order_relaxed);
+    while (1) {
+        uint32_t l = RANGE_LO(cur), h = RANGE_HI(cur);
+        if (l >= h) return 0;
+        uint32_t end = h - l > chunk ? l + chunk : h;
+        if (atomic_compare_exchange_weak(&r->range, &cur, RANGE_PACK(end, h))) {
+            *lo = l;
+            *hi = end;
+            return 1;
+        }
+    }
+}
+
+// Thief side: take the back half of a victim's remaining range
+static int range_steal(forth_range_t* r, uint32_t* lo, uint32_t* hi) {
+    uint64_t cur = atomic_load_explicit(&r->range, memory_order_relaxed);
+    while (1) {
+        uint32_t l = RANGE_LO(cur), h = RANGE_HI(cur);
+        if (l >= h) return 0;
+        uint32_t mid = l + (h - l) / 2;
+        if (atomic_compare_exchange_weak(&r->range, &cur, RANGE_PACK(l, mid))) {
+            *lo = mid;
+            *hi = h;
+            return 1;
+        }
+    }
+}
+
+typedef struct {
+    forth_image_t* img;
+    addr_t xt;
+    const cell_t* args;
+    int nargs;
+    cell_t* results;
+    int nresults;
+    int* status;                // Per item, or NULL
+    _Atomic uint32_t done;      // Items run
+    _Atomic uint32_t failed;    // Items run that didn't return FF_OK
+    forth_range_t ranges[FF_POOL_MAX_THREADS];
+} forth_batch_t;
+
+static void batch_items(forth_batch_t* b, forth_ctx_t* ctx, uint32_t lo, uint32_t hi) {
+    for (uint32_t i = lo; i < hi; i++) {
+        const cell_t* in = b->args + (size_t)i * b->nargs;
+        cell_t* out = b->results + (size_t)i * b->nresults;
+        ctx->sp = 0;
+        ctx->rp = 0;
+        for (int k = 0; k < b->nargs; k++) {
+            PUSH(ctx, in[k]);
+        }
+        int status = execute(b->img, ctx, b->xt);
+        if (b->status) b->status[i] = status;
+        if (status != FF_OK) atomic_fetch_add_explicit(&b->failed, 1, memory_order_relaxed);
+        // Top nresults cells, deepest first; missing ones read as 0
+        for (int k = 0; k < b->nresults; k++) {
+            int idx = ctx->sp - b->nresults + k;
+            out[k] = idx >= 0 ? ctx->ds[idx] : 0;
+        }
+    }
+    atomic_fetch_add_explicit(&b->done, hi - lo, memory_order_relaxed);
+}
+
+static void batch_job(forth_pool_t* pool, int worker, void* arg) {
+    forth_batch_t* b = arg;
+    forth_ctx_t ctx;
+    if (!init_ctx(&ctx)) return;    // The others steal its range
+    
+    uint32_t lo, hi;
+    while (range_take(&b->ranges[worker], FF_BATCH_CHUNK, &lo, &hi)) {
+        batch_items(b, &ctx, lo, hi);
+    }
+    // Own range drained: steal from the others, starting at the neighbour
+    for (int k = 1; k < pool->nthreads; k++) {
+        forth_range_t* victim = &b->ranges[(worker + k) % pool->nthreads];
+        if (!range_steal(victim, &lo, &hi)) continue;
+        // Publish the stolen half as our own so others can steal it back
+        atomic_store(&b->ranges[worker].range, RANGE_PACK(lo, hi));
+        while (range_take(&b->ranges[worker], FF_BATCH_CHUNK, &lo, &hi)) {
+            batch_items(b, &ctx, lo, hi);
+        }
+        k = 0;  // Rescan from the neighbour after each steal
+    }
+    free_ctx(&ctx);
+}
+
+// Evaluate the word at xt over count independent argument tuples.
+// args holds count * nargs cells; results receives count * nresults
+// cells, in input order. Each worker uses its own context. status, if
+// not NULL, receives each item's execute() status (FF_FAULT if it never
+// ran). Returns the number of items that didn't return FF_OK: 0 if all
+// results are good, count if the batch couldn't start.
+static inline uint32_t execute_batch(forth_pool_t* pool, forth_image_t* img, addr_t xt,
+                                     const cell_t* args, int nargs,
+                                     cell_t* results, int nresults, uint32_t count,
+                                     int* status) {
+    if (status) {
+        for (uint32_t i = 0; i < count; i++) status[i] = FF_FAULT;
+    }
+    forth_batch_t* b = malloc(sizeof(*b));
+    if (!b) return count;
+    b->img = img;
+    b->xt = xt;
+    b->args = args;
+    b->nargs = nargs;
+    b->results = results;
+    b->nresults = nresults;
+    b->status = status;
+    atomic_init(&b->done, 0);
+    atomic_init(&b->failed, 0);
+    
+    // Even initial split; stealing evens out data-dependent costs
+    int n = pool->nthreads;
+    for (int i = 0; i < n; i++) {
+        uint32_t lo = (uint32_t)((uint64_t)count * i / n);
+        uint32_t hi = (uint32_t)((uint64_t)count * (i + 1) / n);
+        atomic_init(&b->ranges[i].range, RANGE_PACK(lo, hi));
+    }
+    pool_run(pool, batch_job, b);
+    uint32_t failed = atomic_load(&b->failed) + (count - atomic_load(&b->done));
+    free(b);
+    return failed;
+}
+
+// PAR-DO: per-worker slices of the index range, reduced in worker order.
+// Each slice not yet done gets an equal share of the caller's fuel.
+typedef struct {
+    forth_image_t* img;
+    forth_ctx_t* parent;
+    volatile sig_atomic_t* interrupt;
+    addr_t body;
+    uint8_t kind;
+    cell_t lo, hi;
+    int nslices;
+    int64_t fuel;                               // Per slice
+    forth_par_slice_t* slices;
+    int64_t left[FF_POOL_MAX_THREADS];          // Fuel each slice didn't use
+    int status[FF_POOL_MAX_THREADS];
+} forth_par_t;
+
+static int par_range(forth_image_t* img, forth_ctx_t* parent, volatile sig_atomic_t* interrupt,
+                     addr_t body, uint8_t kind, cell_t lo, cell_t hi, forth_par_slice_t* slice,
+                     int64_t* fuel);
+
+static void par_job(forth_pool_t* pool, int worker, void* arg) {
+    (void)pool;
+    forth_par_t* par = arg;
+    if (worker >= par->nslices) return;
+    par->left[worker] = par->fuel;
+    par->status[worker] = FF_OK;
+    if (par->slices[worker].done) return;
+    int64_t span = (int64_t)par->hi - par->lo;
+    cell_t lo = (cell_t)(par->lo + span * worker / par->nslices);
+    cell_t hi = (cell_t)(par->lo + span * (worker + 1) / par->nslices);
+    par->status[worker] = par_range(par->img, par->parent, par->interrupt, par->body, par->kind,
+                                    lo, hi, &par->slices[worker], &par->left[worker]);
+}
+
+// M:N scheduler: many lightweight VMs (fibers, one context each on a
+// shared image) multiplexed over the thread pool. A fiber runs for
+// FF_SCHED_SLICE safepoints, then goes to the back of the run queue.
+// A fiber blocked in SEND/RECV parks on that channel until some fiber
+// (or the host, via sched_notify) moves data through it; one blocked
+// in KEY parks until the host delivers input with sched_deliver. The
+// host stops a runaway fiber by setting f->ctx.interrupt: at its next
+// safepoint it is done with status FF_INTERRUPTED (a parked fiber once
+// it is woken).
+#ifndef FF_SCHED_SLICE
+#define FF_SCHED_SLICE 1000
+#endif
+#ifndef FF_FIBER_INPUT
+#define FF_FIBER_INPUT 16   // Buffered KEY input per fiber (power of two)
+#endif
+
+typedef enum {
+    FIBER_RUNNABLE,
+    FIBER_RUNNING,
+    FIBER_WAIT_CHANNEL,
+    FIBER_WAIT_INPUT,
+    FIBER_DONE
+} fiber_state_t;
+
+typedef struct forth_fiber forth_fiber_t;
+struct forth_fiber {
+    forth_ctx_t ctx;
+    forth_fiber_t* next;    // Run queue or channel wait list
+    int state;
+    int status;             // Final step() result once FIBER_DONE
+    uint8_t input[FF_FIBER_INPUT];
+    unsigned input_head, input_tail;
+    void* user;             // For the host
+};
+
+typedef struct {
+    forth_image_t* img;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    forth_fiber_t* head;    // Run queue
+    forth_fiber_t* tail;
+    forth_fiber_t* waiting[64];     // Parked on channels, by channels_used bit
+    int running;            // Fibers being stepped right now
+    long live;              // Spawned and not done
+    long slices;
+} forth_sched_t;
+
+// The fiber a worker is stepping, for the KEY callbacks
+static _Thread_local forth_fiber_t* sched_fiber;
+static _Thread_local forth_sched_t* sched_self;
+
+static int fiber_key_ready(void) {
+    return sched_fiber->input_head != ATOMIC_LOAD(&sched_fiber->input_tail);
+}
+
+static int fiber_getchar(void) {
+    forth_fiber_t* f = sched_fiber;
+    pthread_mutex_lock(&sched_self->lock);
+    int c = f->input_head != f->input_tail ? f->input[f->input_head++ % FF_FIBER_INPUT] : -1;
+    pthread_mutex_unlock(&sched_self->lock);
+    return c;
+}
+
+static inline int init_sched(forth_sched_t* s, forth_image_t* img) {
+    memset(s, 0, sizeof(*s));
+    s->img = img;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->wake, NULL);
+    return 1;
+}
+
+static inline void free_sched(forth_sched_t* s) {
+    pthread_cond_destroy(&s->wake);
+    pthread_mutex_destroy(&s->lock);
+}
+
+// Lock held
+static inline void sched_push(forth_sched_t* s, forth_fiber_t* f) {
+    f->state = FIBER_RUNNABLE;
+    f->next = NULL;
+    if (s->tail) s->tail->next = f;
+    else s->head = f;
+    s->tail = f;
+}
+
+// Lock held: make everything parked on the channels in mask runnable
+static inline int sched_wake_channels(forth_sched_t* s, uint64_t mask) {
+    int woken = 0;
+    while (mask) {
+        int bit = FF_CTZ64(mask);
+        mask &= mask - 1;
+        forth_fiber_t* f = s->waiting[bit];
+        s->waiting[bit] = NULL;
+        while (f) {
+            forth_fiber_t* next = f->next;
+            sched_push(s, f);
+            f = next;
+            woken++;
+        }
+    }
+    return woken;
+}
+
+// Start xt on a new fiber with args on its data stack (bottom first).
+// The fiber belongs to the host, which frees it with free_fiber() once
+// it is done.
+static inline forth_fiber_t* sched_spawn(forth_sched_t* s, addr_t xt,
+                                         const cell_t* args, int nargs) {
+    forth_fiber_t* f = calloc(1, sizeof(*f));
+    if (!f || !init_ctx(&f->ctx)) {
+        free(f);
+        return NULL;
+    }
+    f->ctx.io.getchar_fn = fiber_getchar;
+    f->ctx.io.key_ready_fn = fiber_key_ready;
+    for (int i = 0; i < nargs; i++) PUSH(&f->ctx, args[i]);
+    step_start(&f->ctx, xt);
+    pthread_mutex_lock(&s->lock);
+    s->live++;
+    sched_push(s, f);
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+    return f;
+}
+
+static inline void free_fiber(forth_fiber_t* f) {
+    free_ctx(&f->ctx);
+    free(f);
+}
+
+// Give a fiber a character for KEY; 0 if its input buffer is full
+static inline int sched_deliver(forth_sched_t* s, forth_fiber_t* f, int c) {
+    pthread_mutex_lock(&s->lock);
+    int ok = f->input_tail - f->input_head < FF_FIBER_INPUT;
+    if (ok) {
+        f->input[f->input_tail % FF_FIBER_INPUT] = (uint8_t)c;
+        ATOMIC_STORE(&f->input_tail, f->input_tail + 1);
+        if (f->state == FIBER_WAIT_INPUT) {
+            sched_push(s, f);
+            pthread_cond_signal(&s->wake);
+        }
+    }
+    pthread_mutex_unlock(&s->lock);
+    return ok;
+}
+
+// The host sent to or received from channel n outside the scheduler
+static inline void sched_notify(forth_sched_t* s, cell_t n) {
+    pthread_mutex_lock(&s->lock);
+    sched_wake_channels(s, (uint64_t)1 << ((n - 1) & 63));
+    pthread_cond_broadcast(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+}
+
+// Lock held: file a fiber that step() returned FF_BLOCKED for. The
+// channel is checked and the fiber parked under s->lock, which wakers
+// hold too, so a wakeup between its failed attempt and now is not lost:
+// either the check sees it or the waker finds the fiber parked.
+static inline void sched_park(forth_sched_t* s, forth_fiber_t* f) {
+    forth_ctx_t* ctx = &f->ctx;
+    uint8_t op = s->img->dict[ctx->pc];
+    if (op == OP_KEY) {
+        f->state = FIBER_WAIT_INPUT;
+        if (f->input_head != f->input_tail) sched_push(s, f);
+        return;
+    }
+    cell_t n = ctx->sp > 0 ? TOS(ctx) : 0;
+    forth_channel_t* ch = channel_at(s->img, n);
+    int bit = (n - 1) & 63;
+    if (!ch || channel_ready(ch, op == OP_SEND)) {
+        sched_push(s, f);
+        return;
+    }
+    f->state = FIBER_WAIT_CHANNEL;
+    f->next = s->waiting[bit];
+    s->waiting[bit] = f;
+}
+
+static void sched_job(forth_pool_t* pool, int worker, void* arg) {
+    (void)pool;
+    (void)worker;
+    forth_sched_t* s = arg;
+    sched_self = s;
+    pthread_mutex_lock(&s->lock);
+    while (1) {
+        while (!s->head && s->running > 0) {
+            pthread_cond_wait(&s->wake, &s->lock);
+        }
+        forth_fiber_t* f = s->head;
+        if (!f) break;  // Nothing runnable and nothing that could wake one
+        s->head = f->next;
+        if (!s->head) s->tail = NULL;
+        f->state = FIBER_RUNNING;
+        s->running++;
+        pthread_mutex_unlock(&s->lock);
+        
+        sched_fiber = f;
+        f->ctx.channels_used = 0;
+        int status = step(s->img, &f->ctx, FF_SCHED_SLICE);
+        
+        pthread_mutex_lock(&s->lock);
+        s->running--;
+        s->slices++;
+        int woken = f->ctx.channels_used ? sched_wake_channels(s, f->ctx.channels_used) : 0;
+        if (status == FF_OUT_OF_FUEL) {
+            sched_push(s, f);
+        } else if (status == FF_BLOCKED) {
+            sched_park(s, f);
+        } else {
+            f->state = FIBER_DONE;
+            f->status = status;
+            s->live--;
+        }
+        // Others may run the woken fibers, or exit if all went idle
+        if (woken || (!s->head && !s->running)) pthread_cond_broadcast(&s->wake);
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+// Run fibers on the pool until none is runnable: all are done or
+// parked. Deliver input or notify channels, then run again.
+static inline void sched_run(forth_sched_t* s, forth_pool_t* pool) {
+    pool_run(pool, sched_job, s);
+}
+#endif // FF_ENABLE_THREADS
+
+#ifndef FF_PAR_MIN_ITERS
+#define FF_PAR_MIN_ITERS 1024   // Smaller ranges aren't worth waking the pool
+#endif
+
+static cell_t par_identity(uint8_t kind) {
+    switch (kind) {
+        case PAR_MAX: return FF_CELL_MIN;
+        case PAR_MIN: return FF_CELL_MAX;
+        case PAR_AND: return -1;
+        default: return 0;
+    }
+}
+
+static cell_t par_combine(uint8_t kind, cell_t a, cell_t b) {
+    switch (kind) {
+        case PAR_MAX: return a > b ? a : b;
+        case PAR_MIN: return a < b ? a : b;
+        case PAR_AND: return a & b;
+        case PAR_OR: return a | b;
+        default: return (cell_t)((ucell_t)a + (ucell_t)b);
+    }
+}
+
+// Slice contexts: one per thread, reused by every PAR-DO slice the
+// thread runs and freed when it exits. A PAR-DO nested in a slice
+// finds it busy (parent set) and runs on a context of its own.
+static _Thread_local forth_ctx_t* par_slice;
+#ifdef FF_ENABLE_THREADS
+static pthread_key_t par_slice_key;
+static pthread_once_t par_slice_once = PTHREAD_ONCE_INIT;
+
+static void par_slice_free(void* ctx) {
+    free_ctx(ctx);
+    free(ctx);
+}
+
+static void par_slice_key_init(void) {
+    pthread_key_create(&par_slice_key, par_slice_free);
+}
+#endif
+
+static forth_ctx_t* par_slice_acquire(void) {
+    if (par_slice && !par_slice->parent) return par_slice;
+    forth_ctx_t* ctx = malloc(sizeof(*ctx));
+    if (!ctx || !init_ctx(ctx)) {
+        if (ctx) free_ctx(ctx);
+        free(ctx);
+        return NULL;
+    }
+    if (!par_slice) {
+        par_slice = ctx;
+#ifdef FF_ENABLE_THREADS
+        pthread_once(&par_slice_once, par_slice_key_init);
+        pthread_setspecific(par_slice_key, ctx);
+#endif
+    }
+    return ctx;
+}
+
+// Take ctx over from the thread, to suspend a slice on it
+static void par_slice_keep(forth_ctx_t* ctx) {
+    if (ctx != par_slice) return;
+    par_slice = NULL;
+#ifdef FF_ENABLE_THREADS
+    pthread_setspecific(par_slice_key, NULL);
+#endif
+}
+
+static void par_slice_release(forth_ctx_t* ctx) {
+    ctx->parent = NULL;
+    ctx->interrupt_at = NULL;
+    if (ctx != par_slice) {
+        free_ctx(ctx);
+        free(ctx);
+    }
+}
+
+// The status a PAR-DO reports for its slices: running out of fuel, then
+// an interrupt, then any failure (as FF_FAULT) outranks the one before
+static int par_status(int a, int b) {
+    if (b != FF_OK && b != FF_OUT_OF_FUEL && b != FF_INTERRUPTED) b = FF_FAULT;
+    return b > a ? b : a;
+}
+
+// Run the loop body for [lo, hi) on this thread's slice context,
+// starting from the reduction's identity, with *fuel to spend (the rest
+// is left there) and stopping once *interrupt is set. The slice has
+// stacks of its own but sees parent's USER area, heap and input record;
+// it can't ALLOCATE, FREE or RESIZE. The body is ( acc -- acc' ) and
+// ends in LOOP + EXIT, so it returns once the slice is done; slice->acc
+// then holds the slice's result. A slice that runs out of fuel or is
+// interrupted keeps its context in slice->ctx and resumes from there.
+static int par_range(forth_image_t* img, forth_ctx_t* parent, volatile sig_atomic_t* interrupt,
+                     addr_t body, uint8_t kind, cell_t lo, cell_t hi, forth_par_slice_t* slice,
+                     int64_t* fuel) {
+    forth_ctx_t* ctx = slice->ctx;
+    if (!ctx) {
+        slice->acc = par_identity(kind);
+        if (lo >= hi) {
+            slice->done = 1;
+            return FF_OK;
+        }
+        ctx = par_slice_acquire();
+        if (!ctx) return FF_FAULT;
+    }
+    ctx->io = parent->io;
+    ctx->parent = parent->parent ? parent->parent : parent;
+    ctx->interrupt_at = interrupt;
+    ctx->fuel = *fuel;
+    int status;
+    if (slice->ctx) {
+        status = resume(img, ctx);
+    } else {
+        ctx->sp = ctx->rp = 0;
+        ctx->ds[ctx->sp++] = slice->acc;
+        ctx->rs[ctx->rp++] = hi;
+        ctx->rs[ctx->rp++] = lo;
+        status = execute(img, ctx, body);
+    }
+    *fuel = ctx->fuel;
+    if (status == FF_OUT_OF_FUEL || status == FF_INTERRUPTED) {
+        par_slice_keep(ctx);
+        ctx->parent = NULL;
+        ctx->interrupt_at = NULL;
+        slice->ctx = ctx;
+        return status;
+    }
+    if (ctx->sp > 0) slice->acc = TOS(ctx);
+    slice->ctx = NULL;
+    slice->done = 1;
+    par_slice_release(ctx);
+    return par_status(FF_OK, status);
+}
+
+// Fold the loop of the PAR-DO at `at` over [lo, hi) into *acc, spending
+// the caller's *fuel. Not FF_OK if a slice ran out of fuel (*fuel is
+// then 0), was interrupted or failed; *acc is unusable in that case.
+// The first two leave the slices suspended in ctx->par, and the next
+// call for the same PAR-DO continues them.
+static int par_loop(forth_image_t* img, forth_ctx_t* ctx, volatile sig_atomic_t* interrupt,
+                    addr_t at, uint8_t kind, cell_t* acc, cell_t lo, cell_t hi, int64_t* fuel) {
+    addr_t body = at + 4;
+    forth_par_parked_t local;
+    forth_par_parked_t* par = ctx->par;
+    if (par && par->at != at) par_discard(ctx);
+    par = ctx->par;
+    ctx->par = NULL;
+    if (!par) {
+        par = &local;
+        par->at = at;
+        par->nslices = 1;
+#ifdef FF_ENABLE_THREADS
+        if (ctx->pool && (int64_t)hi - lo >= FF_PAR_MIN_ITERS) par->nslices = ctx->pool->nthreads;
+#endif
+        memset(par->slices, 0, (size_t)par->nslices * sizeof(par->slices[0]));
+    }
+    
+    int status = FF_OK;
+#ifdef FF_ENABLE_THREADS
+    if (par->nslices > 1) {
+        int n = par->nslices, live = 0;
+        for (int i = 0; i < n; i++) live += !par->slices[i].done;
+        int64_t share = *fuel / live > 0 ? *fuel / live : 1;
+        forth_par_t job = { img, ctx, interrupt, body, kind, lo, hi, n, share, par->slices, {0}, {0} };
+        pool_run(ctx->pool, par_job, &job);
+        for (int i = 0; i < n; i++) {
+            *fuel -= share - job.left[i];
+            status = par_status(status, job.status[i]);
+        }
+    } else
+#endif
+    if (!par->slices[0].done) {
+        status = par_range(img, ctx, interrupt, body, kind, lo, hi, &par->slices[0], fuel);
+    }
+    if (status == FF_OUT_OF_FUEL || *fuel < 0) *fuel = 0;
+    
+    if (status == FF_OK) {
+        for (int i = 0; i < par->nslices; i++) *acc = par_combine(kind, *acc, par->slices[i].acc);
+    } else if (status == FF_OUT_OF_FUEL || status == FF_INTERRUPTED) {
+        forth_par_parked_t* kept = par == &local ? malloc(sizeof(*kept)) : par;
+        if (kept) {
+            if (kept != par) *kept = local;
+            ctx->par = kept;
+            return status;
+        }
+        par_drop(par);
+        status = FF_FAULT;
+    } else {
+        par_drop(par);  // A slice failed: the others are dropped
+    }
+    if (par != &local) free(par);
+    return status;
+}
+
+// Log an operand at..at+size of the segment being compiled (no-op
+// outside LOAD-PAR); operands cut short by a full dictionary are dropped
+static void note_reloc(forth_t* vm, addr_t at, int size, int kind, int ref) {
+    forth_segment_t* seg = vm->seg;
+    if (!seg || at + size > vm->image.here) return;
+    if (seg->reloc_count == seg->reloc_cap) {
+        int cap = seg->reloc_cap ? seg->reloc_cap * 2 : 64;
+        forth_reloc_t* relocs = realloc(seg->relocs, (size_t)cap * sizeof(*relocs));
+        if (!relocs) {
+            seg->failed = 1;
+            return;
+        }
+        seg->relocs = relocs;
+        seg->reloc_cap = cap;
+    }
+    forth_reloc_t* r = &seg->relocs[seg->reloc_count++];
+    r->at = at;
+    r->size = (uint8_t)size;
+    r->kind = (uint8_t)kind;
+    r->ref = (int16_t)ref;
+}
+
+// Log a reference to word w: words the segment started with are looked
+// up again at link time, in case an earlier file redefined them
+static void note_word(forth_t* vm, addr_t at, int size, const word_t* w) {
+    if (!vm->seg) return;
+    int i = (int)(w - vm->image.words);
+    note_reloc(vm, at, size, i < vm->seg->base_words ? FF_RELOC_WORD : FF_RELOC_ADDR, i);
+}
+
+// Compile a call to a word no file has defined yet; the linker
+// resolves it against the files loaded before this one
+static int compile_extern(forth_t* vm, const char* name) {
+    forth_segment_t* seg = vm->seg;
+    if (seg->extern_count == seg->extern_cap) {
+        int cap = seg->extern_cap ? seg->extern_cap * 2 : 16;
+        char (*externs)[FF_NAME_MAX + 1] = realloc(seg->externs, (size_t)cap * sizeof(*externs));
+        if (!externs) return 0;
+        seg->externs = externs;
+        seg->extern_cap = cap;
+    }
+    strcpy(seg->externs[seg->extern_count], name);
+    forth_image_t* img = &vm->image;
+    emit_byte(img, OP_CALL);
+    addr_t at = img->here;
+    emit_addr(img, 0);
+    note_reloc(vm, at, 2, FF_RELOC_EXTERN, seg->extern_count++);
+    return 1;
+}
+
+static int load_parallel(forth_t* vm, const char** paths, int count);
+static int relayout(forth_t* vm);
+
+// MARKER and FORGET: roll the dictionary back to a saved point. The
+// word table is a plain array searched from the end, so moving here and
+// word_count back is all it takes; USER cells, tasks and channels
+// created since are dropped too, and their profile counts cleared.
+// A marker word's code is an EXIT followed by the USER area offset (2
+// bytes), the task count and the channel count at its definition.
+#define FF_MARKER_SIZE 5
+
+// Whether forgetting from here would pull code out from under a task
+static int forget_busy(forth_t* vm, addr_t here, int tasks) {
+    for (forth_ctx_t* t = vm->ctx.next; t != &vm->ctx; t = t->next) {
+        if (t - vm->tasks >= tasks || t->pc >= here) return 1;
+        for (int i = 0; i < t->rp; i++) {
+            if (t->rs[i] >= here && t->rs[i] < vm->image.here) return 1;
+        }
+    }
+    return 0;
+}
+
+// Drop word slots from index, the dictionary from here, USER cells from
+// data_here, and tasks and channels beyond the given counts. 0 (and
+// nothing changes) if a running task would lose its code.
+static int forget_to(forth_t* vm, int index, addr_t here, int data_here,
+                     int tasks, int channels) {
+    forth_image_t* img = &vm->image;
+    if (vm->compiling || forget_busy(vm, here, tasks)) {
+        io_error(&vm->ctx, "Can't forget a definition in progress or a running task's code\n");
+        return 0;
+    }
+    if (img->calls) memset(&img->calls[here], 0, (size_t)(img->here - here) * sizeof(uint32_t));
+    img->here = here;
+    img->word_count = index;
+    if (data_here < img->data_here) img->data_here = data_here;
+    if (tasks < vm->task_count) vm->task_count = tasks;
+#ifdef FF_ENABLE_THREADS
+    for (int i = channels; i < img->channel_count; i++) {
+        if (img->channel_owned[i]) {
+            free_channel(img->channels[i]);
+            free(img->channels[i]);
+            img->channel_owned[i] = 0;
+        }
+    }
+    if (channels < img->channel_count) img->channel_count = channels;
+#else
+    (void)channels;
+#endif
+    return 1;
+}
+
+// Run a marker word: forget it and everything defined after it
+static int forget_marker(forth_t* vm, word_t* w) {
+    forth_image_t* img = &vm->image;
+    const uint8_t* m = &img->dict[w->addr + 1];
+    return forget_to(vm, (int)(w - img->words), w->addr, m[0] | m[1] << 8, m[2], m[3]);
+}
+
+// FORGET name: forget the word and everything defined after it. Its
+// dictionary space starts at its code, or at its cell for a VARIABLE
+// (LIT addr EXIT, with the cell just before). USER cells and channels
+// go back from the first USER or CHANNEL word forgotten.
+static int forget_word(forth_t* vm, word_t* w) {
+    forth_image_t* img = &vm->image;
+    int index = (int)(w - img->words);
+    if (index < img->builtin_count) {
+        io_error(&vm->ctx, "Can't forget builtin %s\n", w->name);
+        return 0;
+    }
+    addr_t here = w->addr;
+    int data_here = img->data_here;
+    int channels = FF_MAX_CHANNELS;
+    for (int i = index; i < img->word_count; i++) {
+        addr_t a = img->words[i].addr;
+        if (a < here) here = a;
+        if (a + 2 + sizeof(cell_t) > img->here || img->dict[a] != OP_LIT ||
+            img->dict[a + 1 + sizeof(cell_t)] != OP_EXIT) continue;
+        cell_t v = load_cell(&img->dict[a + 1]);
+        uint8_t flags = img->words[i].flags;
+        if (i == index && v + (cell_t)sizeof(cell_t) == a) here = (addr_t)v;
+        if ((flags & FF_WORD_USER) && v >= FF_DATA_BASE && v - FF_DATA_BASE < data_here) {
+            data_here = v - FF_DATA_BASE;
+        }
+        if ((flags & FF_WORD_CHANNEL) && v >= 1 && v - 1 < channels) channels = (int)(v - 1);
+    }
+    for (int i = img->builtin_count; i < index; i++) {
+        if (img->words[i].addr >= here) {
+            io_error(&vm->ctx, "Can't forget %s: RELAYOUT put %s after it\n", w->name,
+                    img->words[i].name);
+            return 0;
+        }
+    }
+    return forget_to(vm, index, here, data_here, vm->task_count, channels);
+}
+
+// Bytecode files (SAVEB, LOADB, forth_fast file.fbc): a header, the
+// dictionary up to here and the word table. Version 2 records the cell
+// size, since LIT operands are stored at that width, and data_here, so
+// USER variables defined after loading don't overlap earlier ones.
+// Version 1 files (32-bit cells, no data_here) still load.
+#define FF_BYTECODE_MAGIC 0x46545448    // "FTTH" (Fast Forth)
+#define FF_BYTECODE_VERSION 2
+
+static int save_bytecode(const forth_image_t* img, FILE* fp) {
+    const uint32_t magic = FF_BYTECODE_MAGIC;
+    const uint16_t version = FF_BYTECODE_VERSION;
+    const uint8_t cell_bytes = sizeof(cell_t);
+    return fwrite(&magic, sizeof(magic), 1, fp) == 1 &&
+           fwrite(&version, sizeof(version), 1, fp) == 1 &&
+           fwrite(&cell_bytes, sizeof(cell_bytes), 1, fp) == 1 &&
+           fwrite(&img->here, sizeof(img->here), 1, fp) == 1 &&
+           fwrite(&img->word_count, sizeof(img->word_count), 1, fp) == 1 &&
+           fwrite(&img->builtin_count, sizeof(img->builtin_count), 1, fp) == 1 &&
+           fwrite(&img->data_here, sizeof(img->data_here), 1, fp) == 1 &&
+           fwrite(img->dict, 1, img->here, fp) == img->here &&
+           fwrite(img->words, sizeof(word_t), (size_t)img->word_count, fp) ==
+               (size_t)img->word_count;
+}
+
+// Replace img's dictionary and words with the file's. 0 (with a
+// message through ctx's I/O) if the file is bad or doesn't fit; img may then be partly
+// overwritten.
+static int load_bytecode(forth_image_t* img, forth_ctx_t* ctx, FILE* fp) {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t cell_bytes = 4;
+    if (fread(&magic, sizeof(magic), 1, fp) != 1 || magic != FF_BYTECODE_MAGIC) {
+        io_error(ctx, "Invalid bytecode file: bad magic\n");
+        return 0;
+    }
+    if (fread(&version, sizeof(version), 1, fp) != 1 || version < 1 ||
+        version > FF_BYTECODE_VERSION ||
+        (version >= 2 && fread(&cell_bytes, sizeof(cell_bytes), 1, fp) != 1)) {
+        io_error(ctx, "Unsupported bytecode version\n");
+        return 0;
+    }
+    if (cell_bytes != sizeof(cell_t)) {
+        io_error(ctx, "Bytecode uses %d-bit cells, this VM %d-bit\n",
+                cell_bytes * 8, FF_CELL_BITS);
+        return 0;
+    }
+    
+    addr_t saved_here;
+    int saved_word_count, saved_builtin_count;
+    int saved_data_here = img->data_here;
+    if (fread(&saved_here, sizeof(saved_here), 1, fp) != 1 ||
+        fread(&saved_word_count, sizeof(saved_word_count), 1, fp) != 1 ||
+        fread(&saved_builtin_count, sizeof(saved_builtin_count), 1, fp) != 1 ||
+        (version >= 2 && fread(&saved_data_here, sizeof(saved_data_here), 1, fp) != 1)) {
+        io_error(ctx, "Invalid bytecode file: short header\n");
+        return 0;
+    }
+    if (saved_here > img->dict_size || saved_word_count < 0 ||
+        saved_word_count > img->max_words || saved_builtin_count < 0 ||
+        saved_builtin_count > saved_word_count ||
+        saved_data_here < 0 || saved_data_here > FF_DATA_SIZE) {
+        io_error(ctx, "Bytecode too large for VM\n");
+        return 0;
+    }
+    if (fread(img->dict, 1, saved_here, fp) != saved_here) {
+        io_error(ctx, "Failed to read dictionary\n");
+        return 0;
+    }
+    if (fread(img->words, sizeof(word_t), (size_t)saved_word_count, fp) !=
+        (size_t)saved_word_count) {
+        io_error(ctx, "Failed to read word table\n");
+        return 0;
+    }
+    
+    mark_dirty(img, 0, saved_here);
+    img->words_low = 0;
+    img->here = saved_here;
+    img->word_count = saved_word_count;
+    img->builtin_count = saved_builtin_count;
+    img->data_here = saved_data_here;
+    return 1;
+}
+
+// Token parsing
+static const char* next_token(forth_t* vm, const char* in) {
+    while (*in && isspace((unsigned char)*in)) in++;
+    if (!*in) return NULL;
+    
+    char* out = vm->token;
+    size_t len = 0;
+    while (*in && !isspace((unsigned char)*in) && len < FF_NAME_MAX) {
+        *out++ = (char)toupper((unsigned char)*in++);
+        len++;
+    }
+    *out = '\0';
+    
+    while (*in && !isspace((unsigned char)*in)) in++;
+    return in;
+}
+
+// Interpret a token: 1 ok, 0 unknown word, -1 execution failed (reported)
+static int interpret_token(forth_t* vm, const char* tok) {
+    forth_image_t* img = &vm->image;
+    forth_ctx_t* ctx = &vm->ctx;
     // Ignore parenthesis comments
     if (strcmp(tok, "(") == 0) {
         return 1;  // Comment, just skip
@@ -763,48 +3481,75 @@ static int interpret_token(forth_t* vm, const char* tok) {
     // Handle I specially - must be inlined, not called
     if (strcmp(tok, "I") == 0) {
         if (vm->compiling) {
-            emit_byte(vm, OP_I);  // Emit directly, no OP_CALL
+            emit_byte(img, OP_I);  // Emit directly, no OP_CALL
         } else {
             // In immediate mode, just push current loop index if available
-            if (vm->rp >= 2) {
-                PUSH(vm, vm->rs[vm->rp - 1]);
+            if (ctx->rp >= 2) {
+                PUSH(ctx, ctx->rs[ctx->rp - 1]);
             }
         }
         return 1;
     }
     
     // Look up word
-    word_t* w = find_word(vm, tok);
+    word_t* w = find_word(img, tok);
+    if (w && (w->flags & FF_WORD_MARKER)) {
+        if (vm->compiling) {
+            io_error(ctx, "Marker %s can only be run from the interpreter\n", tok);
+            return -1;
+        }
+        return forget_marker(vm, w) ? 1 : -1;
+    }
     if (w) {
         if (vm->compiling) {
             // Compile a call to this word
-            emit_byte(vm, OP_CALL);
-            emit_addr(vm, w->addr);
+            emit_byte(img, OP_CALL);
+            addr_t at = img->here;
+            emit_addr(img, w->addr);
+            note_word(vm, at, 2, w);
         } else {
             // Execute immediately
-            execute(vm, w->addr);
+            if (img->calls) img->calls[w->addr]++;
+            int status = execute(img, ctx, w->addr);
+            if (status != FF_OK) {
+                io_error(ctx, "%s in %s\n",
+                        status == FF_INTERRUPTED ? "Interrupted" :
+                        status == FF_OUT_OF_FUEL ? "Out of fuel" :
+                        status == FF_BLOCKED ? "Blocked" :
+                        status == FF_FAULT ? "Invalid memory access" :
+                        status == FF_STACK_FAULT ? "Stack overflow or underflow" : "Error", tok);
+                ctx->sp = 0;
+                ctx->rp = 0;
+                ctx->interrupt = 0;
+                return -1;
+            }
         }
         return 1;
     }
     
     // Try to parse as number
     char* end;
-    long val = strtol(tok, &end, 10);
+    long long val = strtoll(tok, &end, 10);
     if (*tok && *end == '\0') {
         if (vm->compiling) {
-            emit_byte(vm, OP_LIT);
-            emit_cell(vm, (cell_t)val);
+            emit_byte(img, OP_LIT);
+            emit_cell(img, (cell_t)val);
         } else {
-            PUSH(vm, (cell_t)val);
+            PUSH(ctx, (cell_t)val);
         }
         return 1;
     }
     
+    // In a file compiled by LOAD-PAR, may be defined by an earlier file
+    if (vm->compiling && vm->seg) return compile_extern(vm, tok) ? 1 : -1;
+    
     return 0;  // Unknown word
 }
 
 // Interpret a line
 static int interpret_line(forth_t* vm, const char* line) {
+    forth_image_t* img = &vm->image;
+    forth_ctx_t* ctx = &vm->ctx;
     // Handle backslash comments - create a temporary buffer
     char line_buf[256];
     const char* p = line;
@@ -844,64 +3589,264 @@ static int interpret_line(forth_t* vm, const char* line) {
             if (!p) return 0;
             
             // Start compiling
-            addr_t word_addr = vm->here;
-            add_word(vm, vm->token, word_addr);
+            addr_t word_addr = img->here;
+            if (!add_word(img, vm->token, word_addr)) {
+                io_error(ctx, "Word table full\n");
+                return 0;
+            }
             vm->compiling = 1;
             continue;
         }
         
         // Handle semicolon (end definition)
         if (strcmp(t, ";") == 0) {
-            emit_byte(vm, OP_EXIT);
+            int defining = vm->compiling;
             vm->compiling = 0;
+            if (!emit_byte(img, OP_EXIT) && defining) {
+                // Ran out of room: drop the partial definition
+                word_t* w = &img->words[img->word_count - 1];
+                io_error(ctx, "Dictionary full in %s\n", w->name);
+                img->here = w->addr;
+                img->word_count--;
+                return 0;
+            }
             continue;
         }
         
-        // Handle BYE/QUIT/EXIT - exit the REPL
-        if (strcmp(t, "BYE") == 0 || strcmp(t, "QUIT") == 0 || strcmp(t, "EXIT") == 0) {
-            exit(0);
-        }
-        
-        // Handle CONSTANT - create a constant
-        if (strcmp(t, "CONSTANT") == 0) {
+        // Handle MARKER - a word that forgets itself and everything after
+        if (strcmp(t, "MARKER") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "CONSTANT needs a name\n");
+                io_error(ctx, "MARKER needs a name\n");
                 return 0;
             }
-            // Value is on stack
-            if (vm->sp < 1) {
-                fprintf(stderr, "CONSTANT needs a value on stack\n");
+            if (vm->seg) {
+                io_error(ctx, "MARKER can't be used in a file loaded by LOAD-PAR\n");
                 return 0;
             }
-            cell_t val = POP(vm);
-            // Create a word that pushes the constant value
-            addr_t word_addr = vm->here;
-            emit_byte(vm, OP_LIT);
-            emit_cell(vm, val);
-            emit_byte(vm, OP_EXIT);
-            add_word(vm, vm->token, word_addr);
-            continue;
-        }
+            addr_t word_addr = img->here;
+            int channels = 0;
+#ifdef FF_ENABLE_THREADS
+            channels = img->channel_count;
+#endif
+            if (img->here + FF_MARKER_SIZE > img->dict_size) {
+                io_error(ctx, "Dictionary full\n");
+                return 0;
+            }
+            emit_byte(img, OP_EXIT);
+            emit_addr(img, (addr_t)img->data_here);
+            emit_byte(img, (uint8_t)vm->task_count);
+            emit_byte(img, (uint8_t)channels);
+            word_t* w = add_word(img, vm->token, word_addr);
+            if (!w) {
+                img->here = word_addr;
+                io_error(ctx, "Word table full\n");
+                return 0;
+            }
+            w->flags |= FF_WORD_MARKER;
+            continue;
+        }
+        
+        // Handle FORGET - forget a word and everything defined after it
+        if (strcmp(t, "FORGET") == 0) {
+            p = next_token(vm, p);
+            word_t* w = p ? find_word(img, vm->token) : NULL;
+            if (!w) {
+                io_error(ctx, "FORGET needs a word\n");
+                return 0;
+            }
+            if (!forget_word(vm, w)) return 0;
+            continue;
+        }
+        
+        // Handle BYE/QUIT/EXIT - exit the REPL
+        if (strcmp(t, "BYE") == 0 || strcmp(t, "QUIT") == 0 || strcmp(t, "EXIT") == 0) {
+            if (vm->no_exit) return 1;
+            exit(0);
+        }
+        
+        // Handle CONSTANT - create a constant
+        if (strcmp(t, "CONSTANT") == 0) {
+            p = next_token(vm, p);
+            if (!p) {
+                io_error(ctx, "CONSTANT needs a name\n");
+                return 0;
+            }
+            // Value is on stack
+            if (ctx->sp < 1) {
+                io_error(ctx, "CONSTANT needs a value on stack\n");
+                return 0;
+            }
+            cell_t val = POP(ctx);
+            // Create a word that pushes the constant value
+            addr_t word_addr = img->here;
+            emit_byte(img, OP_LIT);
+            emit_cell(img, val);
+            emit_byte(img, OP_EXIT);
+            add_word(img, vm->token, word_addr);
+            continue;
+        }
         
         // Handle VARIABLE - create a variable
         if (strcmp(t, "VARIABLE") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "VARIABLE needs a name\n");
+                io_error(ctx, "VARIABLE needs a name\n");
                 return 0;
             }
-            // Allocate space in dictionary for one cell
-            addr_t var_addr = vm->here;
+            // Allocate one naturally aligned cell, so the atomic words work on it
+            while (img->here & (sizeof(cell_t) - 1)) {
+                if (!emit_byte(img, 0)) break;
+            }
+            addr_t var_addr = img->here;
             for (int i = 0; i < (int)sizeof(cell_t); i++) {
-                emit_byte(vm, 0);
+                emit_byte(img, 0);
             }
             // Create a word that pushes the variable's address
-            addr_t word_addr = vm->here;
-            emit_byte(vm, OP_LIT);
-            emit_cell(vm, var_addr);
-            emit_byte(vm, OP_EXIT);
-            add_word(vm, vm->token, word_addr);
+            addr_t word_addr = img->here;
+            emit_byte(img, OP_LIT);
+            emit_cell(img, var_addr);
+            emit_byte(img, OP_EXIT);
+            note_reloc(vm, word_addr + 1, sizeof(cell_t), FF_RELOC_ADDR, 0);
+            add_word(img, vm->token, word_addr);
+            continue;
+        }
+
+        // Handle CREATE - a word pushing the address of the cell-aligned
+        // data space after it, reserved with ALLOT
+        if (strcmp(t, "CREATE") == 0) {
+            p = next_token(vm, p);
+            if (!p) {
+                io_error(ctx, "CREATE needs a name\n");
+                return 0;
+            }
+            addr_t word_addr = img->here;
+            int data_addr = (word_addr + 2 + (int)sizeof(cell_t) * 2 - 1) & ~((int)sizeof(cell_t) - 1);
+            if (data_addr > img->dict_size) {
+                io_error(ctx, "Dictionary full\n");
+                return 0;
+            }
+            emit_byte(img, OP_LIT);
+            emit_cell(img, data_addr);
+            emit_byte(img, OP_EXIT);
+            while (img->here < data_addr) emit_byte(img, 0);
+            note_reloc(vm, word_addr + 1, sizeof(cell_t), FF_RELOC_ADDR, 0);
+            add_word(img, vm->token, word_addr);
+            continue;
+        }
+
+        // Handle USER - create a per-context variable in the private data area
+        if (strcmp(t, "USER") == 0) {
+            p = next_token(vm, p);
+            if (!p) {
+                io_error(ctx, "USER needs a name\n");
+                return 0;
+            }
+            if (img->data_here + (int)sizeof(cell_t) > FF_DATA_SIZE) {
+                io_error(ctx, "USER area full\n");
+                return 0;
+            }
+            // Same address in every context, resolved to each one's own area
+            cell_t user_addr = FF_DATA_BASE + img->data_here;
+            img->data_here += sizeof(cell_t);
+            addr_t word_addr = img->here;
+            emit_byte(img, OP_LIT);
+            emit_cell(img, user_addr);
+            emit_byte(img, OP_EXIT);
+            note_reloc(vm, word_addr + 1, sizeof(cell_t), FF_RELOC_DATA, 0);
+            word_t* w = add_word(img, vm->token, word_addr);
+            if (w) w->flags |= FF_WORD_USER;
+            continue;
+        }
+
+        // Handle TASK - create a background task
+        if (strcmp(t, "TASK") == 0) {
+            p = next_token(vm, p);
+            if (!p) {
+                io_error(ctx, "TASK needs a name\n");
+                return 0;
+            }
+            if (vm->task_count >= FF_MAX_TASKS) {
+                io_error(ctx, "Too many tasks\n");
+                return 0;
+            }
+            forth_ctx_t* task = &vm->tasks[vm->task_count];
+            free_ctx(task);  // Stacks left from before a reset_vm()
+            if (!init_ctx_sized(task, ctx->ds_size, ctx->rs_size)) {
+                io_error(ctx, "Out of memory\n");
+                return 0;
+            }
+            vm->task_count++;
+            task->io = ctx->io;
+            // The word pushes the task number (1-based)
+            addr_t word_addr = img->here;
+            emit_byte(img, OP_LIT);
+            emit_cell(img, vm->task_count);
+            emit_byte(img, OP_EXIT);
+            add_word(img, vm->token, word_addr);
+            continue;
+        }
+        
+        // Handle ACTIVATE ( xt task -- ) - (re)start a task running xt
+        if (strcmp(t, "ACTIVATE") == 0) {
+            cell_t n = POP(ctx);
+            cell_t xt = POP(ctx);
+            if (n < 1 || n > vm->task_count || xt < 0 || xt >= img->here) {
+                io_error(ctx, "ACTIVATE needs an xt and a task\n");
+                return 0;
+            }
+            forth_ctx_t* task = &vm->tasks[n - 1];
+            par_discard(task);
+            task->sp = 0;
+            task->rp = 0;
+            task->pc = (addr_t)xt;
+            if (task->next == task) {
+                // Not running yet: link into the ring after the main context
+                task->next = ctx->next;
+                ctx->next = task;
+            }
+            continue;
+        }
+        
+#ifdef FF_ENABLE_THREADS
+        // Handle CHANNEL ( capacity -- ) - create a named channel
+        if (strcmp(t, "CHANNEL") == 0) {
+            p = next_token(vm, p);
+            if (!p) {
+                io_error(ctx, "CHANNEL needs a name\n");
+                return 0;
+            }
+            cell_t capacity = POP(ctx);
+            forth_channel_t* ch = capacity >= 1 && capacity <= FF_CHANNEL_MAX ?
+                calloc(1, sizeof(*ch)) : NULL;
+            if (!ch || !init_channel(ch, (size_t)capacity) ||
+                !bind_channel(img, vm->token, ch)) {
+                if (ch) free_channel(ch);
+                free(ch);
+                io_error(ctx, "Cannot create channel %s\n", vm->token);
+                return 0;
+            }
+            img->channel_owned[img->channel_count - 1] = 1;
+            continue;
+        }
+#endif
+        
+        // Handle ' (tick) - address of a word
+        if (strcmp(t, "'") == 0) {
+            p = next_token(vm, p);
+            word_t* w = p ? find_word(img, vm->token) : NULL;
+            if (!w) {
+                io_error(ctx, "' needs a word\n");
+                return 0;
+            }
+            if (vm->compiling) {
+                emit_byte(img, OP_LIT);
+                addr_t at = img->here;
+                emit_cell(img, w->addr);
+                note_word(vm, at, sizeof(cell_t), w);
+            } else {
+                PUSH(ctx, w->addr);
+            }
             continue;
         }
         
@@ -909,51 +3854,51 @@ static int interpret_line(forth_t* vm, const char* line) {
         if (strcmp(t, "SEE") == 0 || strcmp(t, "LIST") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "SEE needs a word name\n");
+                io_error(ctx, "SEE needs a word name\n");
                 return 0;
             }
-            word_t* w = find_word(vm, vm->token);
+            word_t* w = find_word(img, vm->token);
             if (!w) {
-                fprintf(stderr, "? %s\n", vm->token);
+                io_error(ctx, "? %s\n", vm->token);
                 return 0;
             }
             
-            printf(": %s\n", w->name);
+            io_printf(ctx, ": %s\n", w->name);
             addr_t pc = w->addr;
             int indent = 2;
             
-            while (pc < vm->here) {
-                uint8_t op = vm->dict[pc++];
-                printf("%*s", indent, "");
+            while (pc < img->here) {
+                uint8_t op = img->dict[pc++];
+                io_printf(ctx, "%*s", indent, "");
                 
                 if (op == OP_EXIT) {
-                    printf(";\n");
+                    io_printf(ctx, ";\n");
                     break;
                 } else if (op == OP_LIT) {
-                    cell_t val = read_cell(vm, &pc);
-                    printf("LIT %d\n", (int)val);
+                    cell_t val = read_cell(img, &pc);
+                    io_printf(ctx, "LIT %lld\n", (long long)val);
                 } else if (op == OP_CALL) {
-                    addr_t addr = read_addr(vm, &pc);
+                    addr_t addr = read_addr(img, &pc);
                     // Find word name
                     const char* name = "?";
-                    for (int i = 0; i < vm->word_count; i++) {
-                        if (vm->words[i].addr == addr) {
-                            name = vm->words[i].name;
+                    for (int i = 0; i < img->word_count; i++) {
+                        if (img->words[i].addr == addr) {
+                            name = img->words[i].name;
                             break;
                         }
                     }
-                    printf("%s\n", name);
+                    io_printf(ctx, "%s\n", name);
                 } else if (op == OP_BRANCH) {
-                    addr_t target = read_addr(vm, &pc);
-                    printf("BRANCH -> %d\n", target);
+                    addr_t target = read_addr(img, &pc);
+                    io_printf(ctx, "BRANCH -> %d\n", target);
                 } else if (op == OP_BRANCH_IF_ZERO) {
-                    addr_t target = read_addr(vm, &pc);
-                    printf("BRANCH0 -> %d\n", target);
+                    addr_t target = read_addr(img, &pc);
+                    io_printf(ctx, "BRANCH0 -> %d\n", target);
                 } else if (op == OP_DO) {
-                    printf("DO\n");
+                    io_printf(ctx, "DO\n");
                 } else if (op == OP_LOOP) {
-                    addr_t target = read_addr(vm, &pc);
-                    printf("LOOP -> %d\n", target);
+                    addr_t target = read_addr(img, &pc);
+                    io_printf(ctx, "LOOP -> %d\n", target);
                 } else {
                     // Map opcode to name
                     const char* opnames[] = {
@@ -970,9 +3915,9 @@ static int interpret_line(forth_t* vm, const char* line) {
                         "HERE", ".S", "DEPTH", "CLEAR", "WORDS", "SEE"
                     };
                     if (op < sizeof(opnames)/sizeof(opnames[0])) {
-                        printf("%s\n", opnames[op]);
+                        io_printf(ctx, "%s\n", opnames[op]);
                     } else {
-                        printf("OP_%d\n", op);
+                        io_printf(ctx, "OP_%d\n", op);
                     }
                 }
             }
@@ -983,30 +3928,82 @@ static int interpret_line(forth_t* vm, const char* line) {
         if (strcmp(t, "LOAD") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "LOAD needs a filename\n");
+                io_error(ctx, "LOAD needs a filename\n");
                 return 0;
             }
             
-            if (!vm->io.fopen_fn || !vm->io.fgets_fn || !vm->io.fclose_fn) {
-                fprintf(stderr, "File I/O not available\n");
+            if (!ctx->io.fopen_fn || !ctx->io.fgets_fn || !ctx->io.fclose_fn) {
+                io_error(ctx, "File I/O not available\n");
                 return 0;
             }
             
-            FILE* fp = vm->io.fopen_fn(vm->token, "r");
+            FILE* fp = ctx->io.fopen_fn(vm->token, "r");
             if (!fp) {
-                fprintf(stderr, "Cannot open %s\n", vm->token);
+                io_error(ctx, "Cannot open %s\n", vm->token);
                 return 0;
             }
             
             char line[256];
-            while (vm->io.fgets_fn(line, sizeof(line), fp)) {
+            while (ctx->io.fgets_fn(line, sizeof(line), fp)) {
                 if (!interpret_line(vm, line)) {
-                    vm->io.fclose_fn(fp);
+                    ctx->io.fclose_fn(fp);
                     return 0;
                 }
             }
-            vm->io.fclose_fn(fp);
-            printf("Loaded %s\n", vm->token);
+            ctx->io.fclose_fn(fp);
+            io_printf(ctx, "Loaded %s\n", vm->token);
+            continue;
+        }
+        
+        // Handle LOAD-PAR - load the files named on the rest of the line,
+        // compiled in parallel (see load_parallel)
+        if (strcmp(t, "LOAD-PAR") == 0) {
+            if (vm->seg) {
+                io_error(ctx, "LOAD-PAR inside LOAD-PAR\n");
+                return 0;
+            }
+            if (!ctx->io.fopen_fn || !ctx->io.fgets_fn || !ctx->io.fclose_fn) {
+                io_error(ctx, "File I/O not available\n");
+                return 0;
+            }
+            
+            // Names as typed (tokens are upper-cased and truncated)
+            char names[256];
+            const char* paths[FF_LOAD_PAR_MAX];
+            int count = 0;
+            strncpy(names, p, sizeof(names) - 1);
+            names[sizeof(names) - 1] = '\0';
+            char* f = names;
+            while (count < FF_LOAD_PAR_MAX) {
+                while (*f && isspace((unsigned char)*f)) f++;
+                if (!*f) break;
+                paths[count++] = f;
+                while (*f && !isspace((unsigned char)*f)) f++;
+                if (*f) *f++ = '\0';
+            }
+            if (count == 0) {
+                io_error(ctx, "LOAD-PAR needs filenames\n");
+                return 0;
+            }
+            if (!load_parallel(vm, paths, count)) return 0;
+            p += strlen(p);
+            continue;
+        }
+        
+        // Handle PROFILE - count calls per word from now on (see RELAYOUT)
+        if (strcmp(t, "PROFILE") == 0) {
+            if (!img->calls) img->calls = malloc((size_t)img->dict_size * sizeof(uint32_t));
+            if (!img->calls) {
+                io_error(ctx, "Out of memory\n");
+                return 0;
+            }
+            memset(img->calls, 0, (size_t)img->dict_size * sizeof(uint32_t));
+            continue;
+        }
+        
+        // Handle RELAYOUT - pack hot words together (see relayout)
+        if (strcmp(t, "RELAYOUT") == 0) {
+            if (!relayout(vm)) return 0;
             continue;
         }
         
@@ -1014,79 +4011,84 @@ static int interpret_line(forth_t* vm, const char* line) {
         if (strcmp(t, "SAVE") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "SAVE needs a filename\n");
+                io_error(ctx, "SAVE needs a filename\n");
                 return 0;
             }
             
-            if (!vm->io.fopen_fn || !vm->io.fputs_fn || !vm->io.fclose_fn) {
-                fprintf(stderr, "File I/O not available\n");
+            if (!ctx->io.fopen_fn || !ctx->io.fputs_fn || !ctx->io.fclose_fn) {
+                io_error(ctx, "File I/O not available\n");
                 return 0;
             }
             
-            FILE* fp = vm->io.fopen_fn(vm->token, "w");
+            FILE* fp = ctx->io.fopen_fn(vm->token, "w");
             if (!fp) {
-                fprintf(stderr, "Cannot create %s\n", vm->token);
+                io_error(ctx, "Cannot create %s\n", vm->token);
                 return 0;
             }
             
             // Save only user-defined words (after builtins)
-            for (int i = vm->builtin_count; i < vm->word_count; i++) {
-                word_t* w = &vm->words[i];
+            for (int i = img->builtin_count; i < img->word_count; i++) {
+                word_t* w = &img->words[i];
                 char buf[512];
+                if (w->flags & FF_WORD_MARKER) {
+                    snprintf(buf, sizeof(buf), "MARKER %s\n", w->name);
+                    ctx->io.fputs_fn(buf, fp);
+                    continue;
+                }
                 snprintf(buf, sizeof(buf), ": %s ", w->name);
-                vm->io.fputs_fn(buf, fp);
+                ctx->io.fputs_fn(buf, fp);
                 
                 // Decompile the word
                 addr_t pc = w->addr;
-                while (pc < vm->here) {
-                    uint8_t op = vm->dict[pc++];
+                while (pc < img->here) {
+                    uint8_t op = img->dict[pc++];
                     if (op == OP_EXIT) {
-                        vm->io.fputs_fn(";\n", fp);
+                        ctx->io.fputs_fn(";\n", fp);
                         break;
                     } else if (op == OP_LIT) {
-                        cell_t val = read_cell(vm, &pc);
-                        snprintf(buf, sizeof(buf), "%d ", (int)val);
-                        vm->io.fputs_fn(buf, fp);
+                        cell_t val = read_cell(img, &pc);
+                        snprintf(buf, sizeof(buf), "%lld ", (long long)val);
+                        ctx->io.fputs_fn(buf, fp);
                     } else if (op == OP_CALL) {
-                        addr_t addr = read_addr(vm, &pc);
-                        for (int j = 0; j < vm->word_count; j++) {
-                            if (vm->words[j].addr == addr) {
-                                snprintf(buf, sizeof(buf), "%s ", vm->words[j].name);
-                                vm->io.fputs_fn(buf, fp);
+                        addr_t addr = read_addr(img, &pc);
+                        for (int j = 0; j < img->word_count; j++) {
+                            if (img->words[j].addr == addr) {
+                                snprintf(buf, sizeof(buf), "%s ", img->words[j].name);
+                                ctx->io.fputs_fn(buf, fp);
                                 break;
                             }
                         }
                     } else if (op == OP_BRANCH) {
                         // Check if this is a ." pattern:
                         // BRANCH -> string_data -> LIT addr -> LIT len -> TYPE
-                        addr_t branch_target = read_addr(vm, &pc);
+                        addr_t branch_target = read_addr(img, &pc);
                         addr_t saved_pc = pc;
                         
                         // Check if pattern matches ." (BRANCH skips string, then LIT, LIT, TYPE)
-                        if (branch_target > pc && branch_target < vm->here &&
-                            vm->dict[branch_target] == OP_LIT) {
+                        if (branch_target > pc && branch_target < img->here &&
+                            img->dict[branch_target] == OP_LIT) {
                             
                             addr_t check_pc = branch_target;
                             check_pc++; // Skip OP_LIT
-                            cell_t str_addr = read_cell(vm, &check_pc);
+                            cell_t str_addr = read_cell(img, &check_pc);
                             
-                            if (vm->dict[check_pc] == OP_LIT) {
+                            if (img->dict[check_pc] == OP_LIT) {
                                 check_pc++; // Skip second OP_LIT
-                                cell_t str_len = read_cell(vm, &check_pc);
+                                cell_t str_len = read_cell(img, &check_pc);
                                 
-                                if (vm->dict[check_pc] == OP_TYPE && 
+                                if (img->dict[check_pc] == OP_TYPE && 
                                     str_addr == saved_pc && 
                                     str_addr + str_len == branch_target) {
                                     // It's a ." pattern!
-                                    vm->io.fputs_fn(".\" ", fp);
+                                    ctx->io.fputs_fn(".\" ", fp);
                                     for (cell_t i = 0; i < str_len; i++) {
-                                        char c = vm->dict[str_addr + i];
+                                        char c = img->dict[str_addr + i];
                                         if (c == '"' || c == '\\') {
                                             fputc('\\', fp);
                                         }
                                         fputc(c, fp);
                                     }
-                                    vm->io.fputs_fn("\" ", fp);
+                                    ctx->io.fputs_fn("\" ", fp);
                                     
                                     // Skip the string data, LIT, LIT, TYPE
                                     pc = check_pc + 1;
@@ -1096,7 +4098,7 @@ static int interpret_line(forth_t* vm, const char* line) {
                         }
                         
                         // Not a ." pattern, treat as ELSE or other branch
-                        vm->io.fputs_fn("ELSE ", fp);
+                        ctx->io.fputs_fn("ELSE ", fp);
                     } else {
                         // Map opcodes to words
                         const char* op_word = NULL;
@@ -1113,24 +4115,25 @@ static int interpret_line(forth_t* vm, const char* line) {
                         else if (op == OP_CR) op_word = "CR ";
                         else if (op == OP_I) op_word = "I ";
                         else if (op == OP_DO) op_word = "DO ";
+                        else if (op == OP_PAUSE) op_word = "PAUSE ";
                         else if (op == OP_LOOP) {
-                            read_addr(vm, &pc);
+                            read_addr(img, &pc);
                             op_word = "LOOP ";
                         }
                         else if (op == OP_BRANCH_IF_ZERO) {
-                            read_addr(vm, &pc);
+                            read_addr(img, &pc);
                             op_word = "IF ";
                         }
                         
                         if (op_word) {
-                            vm->io.fputs_fn(op_word, fp);
+                            ctx->io.fputs_fn(op_word, fp);
                         }
                     }
                 }
             }
             
-            vm->io.fclose_fn(fp);
-            printf("Saved %d words to %s\n", vm->word_count - vm->builtin_count, vm->token);
+            ctx->io.fclose_fn(fp);
+            io_printf(ctx, "Saved %d words to %s\n", img->word_count - img->builtin_count, vm->token);
             continue;
         }
         
@@ -1138,39 +4141,32 @@ static int interpret_line(forth_t* vm, const char* line) {
         if (strcmp(t, "SAVEB") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "SAVEB needs a filename\n");
+                io_error(ctx, "SAVEB needs a filename\n");
                 return 0;
             }
             
-            if (!vm->io.fopen_fn || !vm->io.fclose_fn) {
-                fprintf(stderr, "File I/O not available\n");
+            if (!ctx->io.fopen_fn || !ctx->io.fclose_fn) {
+                io_error(ctx, "File I/O not available\n");
                 return 0;
             }
             
-            FILE* fp = vm->io.fopen_fn(vm->token, "wb");
+            // Profiled: save the hot words packed together (a failed
+            // relayout leaves the image as it was)
+            if (img->calls) relayout(vm);
+            
+            FILE* fp = ctx->io.fopen_fn(vm->token, "wb");
             if (!fp) {
-                fprintf(stderr, "Cannot create %s\n", vm->token);
+                io_error(ctx, "Cannot create %s\n", vm->token);
                 return 0;
             }
             
-            // Write header: magic number, version, metadata
-            const uint32_t magic = 0x46545448;  // "FTTH" (Fast Forth)
-            const uint16_t version = 1;
-            fwrite(&magic, sizeof(magic), 1, fp);
-            fwrite(&version, sizeof(version), 1, fp);
-            fwrite(&vm->here, sizeof(vm->here), 1, fp);
-            fwrite(&vm->word_count, sizeof(vm->word_count), 1, fp);
-            fwrite(&vm->builtin_count, sizeof(vm->builtin_count), 1, fp);
-            
-            // Write dictionary
-            fwrite(vm->dict, 1, vm->here, fp);
-            
-            // Write word table
-            fwrite(vm->words, sizeof(word_t), vm->word_count, fp);
-            
-            fclose(fp);
-            printf("Saved bytecode (%d bytes, %d words) to %s\n", 
-                   vm->here, vm->word_count, vm->token);
+            int saved = save_bytecode(img, fp);
+            if (fclose(fp) != 0 || !saved) {
+                io_error(ctx, "Failed to write %s\n", vm->token);
+                return 0;
+            }
+            io_printf(ctx, "Saved bytecode (%d bytes, %d words) to %s\n", 
+                           img->here, img->word_count, vm->token);
             continue;
         }
         
@@ -1178,70 +4174,26 @@ static int interpret_line(forth_t* vm, const char* line) {
         if (strcmp(t, "LOADB") == 0) {
             p = next_token(vm, p);
             if (!p) {
-                fprintf(stderr, "LOADB needs a filename\n");
+                io_error(ctx, "LOADB needs a filename\n");
                 return 0;
             }
             
-            if (!vm->io.fopen_fn || !vm->io.fclose_fn) {
-                fprintf(stderr, "File I/O not available\n");
+            if (!ctx->io.fopen_fn || !ctx->io.fclose_fn) {
+                io_error(ctx, "File I/O not available\n");
                 return 0;
             }
             
-            FILE* fp = vm->io.fopen_fn(vm->token, "rb");
+            FILE* fp = ctx->io.fopen_fn(vm->token, "rb");
             if (!fp) {
-                fprintf(stderr, "Cannot open %s\n", vm->token);
-                return 0;
-            }
-            
-            // Read and verify header
-            uint32_t magic;
-            uint16_t version;
-            if (fread(&magic, sizeof(magic), 1, fp) != 1 || magic != 0x46545448) {
-                fprintf(stderr, "Invalid bytecode file: bad magic\n");
-                fclose(fp);
-                return 0;
-            }
-            if (fread(&version, sizeof(version), 1, fp) != 1 || version != 1) {
-                fprintf(stderr, "Unsupported bytecode version\n");
-                fclose(fp);
-                return 0;
-            }
-            
-            addr_t saved_here;
-            int saved_word_count, saved_builtin_count;
-            fread(&saved_here, sizeof(saved_here), 1, fp);
-            fread(&saved_word_count, sizeof(saved_word_count), 1, fp);
-            fread(&saved_builtin_count, sizeof(saved_builtin_count), 1, fp);
-            
-            // Validate sizes
-            if (saved_here > FF_DICT_SIZE || saved_word_count > FF_MAX_WORDS) {
-                fprintf(stderr, "Bytecode too large for VM\n");
-                fclose(fp);
-                return 0;
-            }
-            
-            // Read dictionary
-            if (fread(vm->dict, 1, saved_here, fp) != saved_here) {
-                fprintf(stderr, "Failed to read dictionary\n");
-                fclose(fp);
+                io_error(ctx, "Cannot open %s\n", vm->token);
                 return 0;
             }
             
-            // Read word table
-            if (fread(vm->words, sizeof(word_t), saved_word_count, fp) != 
-                (size_t)saved_word_count) {
-                fprintf(stderr, "Failed to read word table\n");
-                fclose(fp);
-                return 0;
-            }
-            
-            vm->here = saved_here;
-            vm->word_count = saved_word_count;
-            vm->builtin_count = saved_builtin_count;
-            
+            int loaded = load_bytecode(img, ctx, fp);
             fclose(fp);
-            printf("Loaded bytecode (%d bytes, %d words) from %s\n", 
-                   vm->here, vm->word_count, vm->token);
+            if (!loaded) return 0;
+            io_printf(ctx, "Loaded bytecode (%d bytes, %d words) from %s\n", 
+                           img->here, img->word_count, vm->token);
             continue;
         }
         
@@ -1252,7 +4204,7 @@ static int interpret_line(forth_t* vm, const char* line) {
             const char* str_start = p;
             while (*p && *p != '"') p++;
             if (*p != '"') {
-                fprintf(stderr, "Unterminated string in .\"\n");
+                io_error(ctx, "Unterminated string in .\"\n");
                 return 0;
             }
             size_t str_len = p - str_start;
@@ -1260,31 +4212,36 @@ static int interpret_line(forth_t* vm, const char* line) {
             
             if (vm->compiling) {
                 // Emit BRANCH to skip over string data
-                emit_byte(vm, OP_BRANCH);
-                addr_t branch_loc = vm->here;
-                emit_addr(vm, 0);  // Placeholder
+                emit_byte(img, OP_BRANCH);
+                addr_t branch_loc = img->here;
+                emit_addr(img, 0);  // Placeholder
+                note_reloc(vm, branch_loc, 2, FF_RELOC_ADDR, 0);
                 
                 // Store string in dictionary
-                addr_t str_addr = vm->here;
+                addr_t str_addr = img->here;
                 for (size_t i = 0; i < str_len; i++) {
-                    emit_byte(vm, (uint8_t)str_start[i]);
+                    emit_byte(img, (uint8_t)str_start[i]);
                 }
                 
                 // Patch branch to jump here
-                patch_addr(vm, branch_loc, vm->here);
+                patch_addr(img, branch_loc, img->here);
                 
                 // Emit TYPE instruction with address and length
-                emit_byte(vm, OP_LIT);
-                emit_cell(vm, str_addr);
-                emit_byte(vm, OP_LIT);
-                emit_cell(vm, (cell_t)str_len);
-                emit_byte(vm, OP_TYPE);
+                emit_byte(img, OP_LIT);
+                addr_t at = img->here;
+                emit_cell(img, str_addr);
+                note_reloc(vm, at, sizeof(cell_t), FF_RELOC_ADDR, 0);
+                emit_byte(img, OP_LIT);
+                emit_cell(img, (cell_t)str_len);
+                emit_byte(img, OP_TYPE);
             } else {
                 // Immediate mode - just print it
-                for (size_t i = 0; i < str_len; i++) {
-                    putchar(str_start[i]);
+                if (ctx->io.putchar_fn) {
+                    for (size_t i = 0; i < str_len; i++) {
+                        ctx->io.putchar_fn((unsigned char)str_start[i]);
+                    }
+                    if (ctx->io.flush_fn) ctx->io.flush_fn();
                 }
-                fflush(stdout);
             }
             continue;
         }
@@ -1292,38 +4249,40 @@ static int interpret_line(forth_t* vm, const char* line) {
         // Handle IF (compile-only)
         if (strcmp(t, "IF") == 0) {
             if (!vm->compiling) {
-                fprintf(stderr, "IF only works in compilation mode\n");
+                io_error(ctx, "IF only works in compilation mode\n");
                 return 0;
             }
-            emit_byte(vm, OP_BRANCH_IF_ZERO);
-            vm->cstack[vm->csp++] = vm->here;  // Save location to patch
-            emit_addr(vm, 0);  // Placeholder
+            emit_byte(img, OP_BRANCH_IF_ZERO);
+            vm->cstack[vm->csp++] = img->here;  // Save location to patch
+            emit_addr(img, 0);  // Placeholder
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
             continue;
         }
         
         // Handle THEN (compile-only)
         if (strcmp(t, "THEN") == 0) {
             if (!vm->compiling || vm->csp == 0) {
-                fprintf(stderr, "THEN without IF\n");
+                io_error(ctx, "THEN without IF\n");
                 return 0;
             }
             addr_t if_addr = vm->cstack[--vm->csp];
-            patch_addr(vm, if_addr, vm->here);  // Patch IF to jump here
+            patch_addr(img, if_addr, img->here);  // Patch IF to jump here
             continue;
         }
         
         // Handle ELSE (compile-only)
         if (strcmp(t, "ELSE") == 0) {
             if (!vm->compiling || vm->csp == 0) {
-                fprintf(stderr, "ELSE without IF\n");
+                io_error(ctx, "ELSE without IF\n");
                 return 0;
             }
-            emit_byte(vm, OP_BRANCH);  // Unconditional jump over ELSE clause
-            addr_t else_addr = vm->here;
-            emit_addr(vm, 0);  // Placeholder
+            emit_byte(img, OP_BRANCH);  // Unconditional jump over ELSE clause
+            addr_t else_addr = img->here;
+            emit_addr(img, 0);  // Placeholder
+            note_reloc(vm, else_addr, 2, FF_RELOC_ADDR, 0);
             
             addr_t if_addr = vm->cstack[--vm->csp];
-            patch_addr(vm, if_addr, vm->here);  // Patch IF to jump here
+            patch_addr(img, if_addr, img->here);  // Patch IF to jump here
             vm->cstack[vm->csp++] = else_addr;  // Save ELSE location for THEN
             continue;
         }
@@ -1331,65 +4290,135 @@ static int interpret_line(forth_t* vm, const char* line) {
         // Handle DO (compile-only)
         if (strcmp(t, "DO") == 0) {
             if (!vm->compiling) {
-                fprintf(stderr, "DO only works in compilation mode\n");
+                io_error(ctx, "DO only works in compilation mode\n");
                 return 0;
             }
-            emit_byte(vm, OP_DO);
-            vm->cstack[vm->csp++] = vm->here;  // Save address AFTER OP_DO for LOOP to jump back to
+            emit_byte(img, OP_DO);
+            vm->cstack[vm->csp++] = img->here;  // Save address AFTER OP_DO for LOOP to jump back to
             continue;
         }
         
         // Handle LOOP (compile-only)
         if (strcmp(t, "LOOP") == 0) {
             if (!vm->compiling || vm->csp == 0) {
-                fprintf(stderr, "LOOP without DO\n");
+                io_error(ctx, "LOOP without DO\n");
                 return 0;
             }
-            emit_byte(vm, OP_LOOP);
+            emit_byte(img, OP_LOOP);
             addr_t loop_start = vm->cstack[--vm->csp];
-            emit_addr(vm, loop_start);  // Jump back to DO
+            emit_addr(img, loop_start);  // Jump back to DO
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
+            continue;
+        }
+        
+        // Handle PAR-DO (compile-only)
+        if (strcmp(t, "PAR-DO") == 0) {
+            if (!vm->compiling) {
+                io_error(ctx, "PAR-DO only works in compilation mode\n");
+                return 0;
+            }
+            emit_byte(img, OP_PAR_DO);
+            vm->cstack[vm->csp++] = img->here;  // Reduction kind, then end address
+            emit_byte(img, PAR_ADD);
+            emit_addr(img, 0);  // Placeholder
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
+            continue;
+        }
+        
+        // Handle PAR-LOOP <reduction> (compile-only)
+        if (strcmp(t, "PAR-LOOP") == 0) {
+            if (!vm->compiling || vm->csp == 0) {
+                io_error(ctx, "PAR-LOOP without PAR-DO\n");
+                return 0;
+            }
+            p = next_token(vm, p);
+            static const char* reductions[] = { "+", "MAX", "MIN", "AND", "OR" };
+            int kind = -1;
+            for (int i = 0; p && i < (int)(sizeof(reductions) / sizeof(reductions[0])); i++) {
+                if (strcmp(vm->token, reductions[i]) == 0) kind = i;
+            }
+            if (kind < 0) {
+                io_error(ctx, "PAR-LOOP needs a reduction: + MAX MIN AND OR\n");
+                return 0;
+            }
+            addr_t kind_addr = vm->cstack[--vm->csp];
+            addr_t body = kind_addr + 3;
+            emit_byte(img, OP_LOOP);
+            emit_addr(img, body);
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
+            emit_byte(img, OP_EXIT);  // Ends each worker's slice
+            mark_dirty(img, kind_addr, 1);
+            img->dict[kind_addr] = (uint8_t)kind;
+            patch_addr(img, kind_addr + 1, img->here);
             continue;
         }
         
         // Handle BEGIN (compile-only)
         if (strcmp(t, "BEGIN") == 0) {
             if (!vm->compiling) {
-                fprintf(stderr, "BEGIN only works in compilation mode\n");
+                io_error(ctx, "BEGIN only works in compilation mode\n");
                 return 0;
             }
-            vm->cstack[vm->csp++] = vm->here;  // Mark loop start
+            vm->cstack[vm->csp++] = img->here;  // Mark loop start
+            continue;
+        }
+        
+        // Handle AGAIN (compile-only)
+        if (strcmp(t, "AGAIN") == 0) {
+            if (!vm->compiling || vm->csp == 0) {
+                io_error(ctx, "AGAIN without BEGIN\n");
+                return 0;
+            }
+            emit_byte(img, OP_BRANCH);  // Jump back to BEGIN forever
+            emit_addr(img, vm->cstack[--vm->csp]);
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
+            continue;
+        }
+        
+        // Handle UNTIL (compile-only)
+        if (strcmp(t, "UNTIL") == 0) {
+            if (!vm->compiling || vm->csp == 0) {
+                io_error(ctx, "UNTIL without BEGIN\n");
+                return 0;
+            }
+            emit_byte(img, OP_BRANCH_IF_ZERO);  // Loop back while TOS is false
+            emit_addr(img, vm->cstack[--vm->csp]);
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
             continue;
         }
         
         // Handle WHILE (compile-only)
         if (strcmp(t, "WHILE") == 0) {
             if (!vm->compiling || vm->csp == 0) {
-                fprintf(stderr, "WHILE without BEGIN\n");
+                io_error(ctx, "WHILE without BEGIN\n");
                 return 0;
             }
-            emit_byte(vm, OP_BRANCH_IF_ZERO);  // Exit loop if TOS is false (zero)
-            vm->cstack[vm->csp++] = vm->here;  // Save location to patch for exit
-            emit_addr(vm, 0);  // Placeholder for exit address
+            emit_byte(img, OP_BRANCH_IF_ZERO);  // Exit loop if TOS is false (zero)
+            vm->cstack[vm->csp++] = img->here;  // Save location to patch for exit
+            emit_addr(img, 0);  // Placeholder for exit address
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
             continue;
         }
         
         // Handle REPEAT (compile-only)
         if (strcmp(t, "REPEAT") == 0) {
             if (!vm->compiling || vm->csp < 2) {
-                fprintf(stderr, "REPEAT without BEGIN/WHILE\n");
+                io_error(ctx, "REPEAT without BEGIN/WHILE\n");
                 return 0;
             }
             addr_t while_addr = vm->cstack[--vm->csp];  // WHILE's branch location
             addr_t begin_addr = vm->cstack[--vm->csp];  // BEGIN location
-            emit_byte(vm, OP_BRANCH);  // Unconditional jump back to BEGIN
-            emit_addr(vm, begin_addr);
-            patch_addr(vm, while_addr, vm->here);  // WHILE exits to here
+            emit_byte(img, OP_BRANCH);  // Unconditional jump back to BEGIN
+            emit_addr(img, begin_addr);
+            note_reloc(vm, img->here - 2, 2, FF_RELOC_ADDR, 0);
+            patch_addr(img, while_addr, img->here);  // WHILE exits to here
             continue;
         }
         
         // Interpret/compile token
-        if (!interpret_token(vm, t)) {
-            fprintf(stderr, "? %s\n", t);
+        int r = interpret_token(vm, t);
+        if (r <= 0) {
+            if (r == 0) io_error(ctx, "? %s\n", t);
             return 0;
         }
     }
@@ -1397,315 +4426,1631 @@ static int interpret_line(forth_t* vm, const char* line) {
     return 1;
 }
 
-// Initialize VM
-static void init_forth(forth_t* vm) {
+static void free_forth(forth_t* vm);
+
+// Initialize a VM with the given segment sizes (NULL: the FF_ defaults).
+// 0 if out of memory or the sizes leave no room beyond the builtins;
+// free_forth() releases the segments either way.
+static int init_forth_sized(forth_t* vm, const forth_sizes_t* sizes) {
+    static const forth_sizes_t defaults = {
+        FF_STACK_DEPTH, FF_RET_DEPTH, FF_DICT_SIZE, FF_MAX_WORDS
+    };
+    if (!sizes) sizes = &defaults;
     memset(vm, 0, sizeof(*vm));
-    
-    // Setup default I/O callbacks
-    vm->io.getchar_fn = getchar;
-    vm->io.putchar_fn = default_putchar;
-    vm->io.flush_fn = default_flush;
-    vm->io.fopen_fn = fopen;
-    vm->io.fclose_fn = fclose;
-    vm->io.fgets_fn = fgets;
-    vm->io.fputs_fn = fputs;
+    if (sizes->data_stack < 1 || sizes->return_stack < 1 || sizes->words < 1 ||
+        sizes->dict < 1 || sizes->dict > FF_DICT_MAX ||
+        !init_image(&vm->image, sizes->dict, sizes->words) ||
+        !init_ctx_sized(&vm->ctx, sizes->data_stack, sizes->return_stack)) {
+        return 0;
+    }
+    forth_image_t* img = &vm->image;
     
     // Add primitive words that just execute inline bytecode
     // + primitive
-    addr_t addr = vm->here;
-    emit_byte(vm, OP_ADD);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "+", addr);
+    addr_t addr = img->here;
+    emit_byte(img, OP_ADD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "+", addr);
     
     // - primitive
-    addr = vm->here;
-    emit_byte(vm, OP_SUB);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "-", addr);
+    addr = img->here;
+    emit_byte(img, OP_SUB);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "-", addr);
     
     // * primitive
-    addr = vm->here;
-    emit_byte(vm, OP_MUL);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "*", addr);
+    addr = img->here;
+    emit_byte(img, OP_MUL);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "*", addr);
     
     // / primitive
-    addr = vm->here;
-    emit_byte(vm, OP_DIV);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "/", addr);
+    addr = img->here;
+    emit_byte(img, OP_DIV);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "/", addr);
     
     // DUP primitive
-    addr = vm->here;
-    emit_byte(vm, OP_DUP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "DUP", addr);
+    addr = img->here;
+    emit_byte(img, OP_DUP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "DUP", addr);
     
     // DROP primitive
-    addr = vm->here;
-    emit_byte(vm, OP_DROP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "DROP", addr);
+    addr = img->here;
+    emit_byte(img, OP_DROP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "DROP", addr);
     
     // SWAP primitive
-    addr = vm->here;
-    emit_byte(vm, OP_SWAP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "SWAP", addr);
+    addr = img->here;
+    emit_byte(img, OP_SWAP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "SWAP", addr);
     
     // OVER primitive
-    addr = vm->here;
-    emit_byte(vm, OP_OVER);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "OVER", addr);
+    addr = img->here;
+    emit_byte(img, OP_OVER);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "OVER", addr);
     
     // . primitive
-    addr = vm->here;
-    emit_byte(vm, OP_DOT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, ".", addr);
+    addr = img->here;
+    emit_byte(img, OP_DOT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, ".", addr);
     
     // Bitwise operations
-    addr = vm->here;
-    emit_byte(vm, OP_AND);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "AND", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_OR);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "OR", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_XOR);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "XOR", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_NOT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "NOT", addr);
+    addr = img->here;
+    emit_byte(img, OP_AND);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "AND", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_OR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "OR", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_XOR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "XOR", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_NOT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "NOT", addr);
     
     // Comparisons
-    addr = vm->here;
-    emit_byte(vm, OP_LT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "<", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_GT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, ">", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_EQ);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "=", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_LE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "<=", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_GE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, ">=", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_NE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "<>", addr);
+    addr = img->here;
+    emit_byte(img, OP_LT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "<", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_GT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, ">", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_EQ);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "=", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_LE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "<=", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_GE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, ">=", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_NE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "<>", addr);
     
     // Memory operations
-    addr = vm->here;
-    emit_byte(vm, OP_LOAD);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "@", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_STORE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "!", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_LOAD_BYTE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "C@", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_STORE_BYTE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "C!", addr);
+    addr = img->here;
+    emit_byte(img, OP_LOAD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "@", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_STORE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "!", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_LOAD_BYTE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "C@", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_STORE_BYTE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "C!", addr);
     
     // Loop index
-    addr = vm->here;
-    emit_byte(vm, OP_I);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "I", addr);
+    addr = img->here;
+    emit_byte(img, OP_I);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "I", addr);
     
     // Stack ops extended
-    addr = vm->here;
-    emit_byte(vm, OP_ROT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "ROT", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_2DUP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "2DUP", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_2DROP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "2DROP", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_NIP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "NIP", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_TUCK);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "TUCK", addr);
+    addr = img->here;
+    emit_byte(img, OP_ROT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ROT", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_2DUP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "2DUP", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_2DROP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "2DROP", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_NIP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "NIP", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_TUCK);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "TUCK", addr);
     
     // Return stack
-    addr = vm->here;
-    emit_byte(vm, OP_TO_R);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, ">R", addr);
+    addr = img->here;
+    emit_byte(img, OP_TO_R);
+    emit_byte(img, OP_EXIT);
+    add_word(img, ">R", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_R_FROM);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "R>", addr);
+    addr = img->here;
+    emit_byte(img, OP_R_FROM);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "R>", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_R_FETCH);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "R@", addr);
+    addr = img->here;
+    emit_byte(img, OP_R_FETCH);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "R@", addr);
     
     // Arithmetic extended
-    addr = vm->here;
-    emit_byte(vm, OP_MOD);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "MOD", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_NEGATE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "NEGATE", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_ABS);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "ABS", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_MIN);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "MIN", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_MAX_OP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "MAX", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_DIVMOD);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "/MOD", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_1PLUS);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "1+", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_1MINUS);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "1-", addr);
+    addr = img->here;
+    emit_byte(img, OP_MOD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "MOD", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_NEGATE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "NEGATE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ABS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ABS", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_MIN);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "MIN", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_MAX_OP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "MAX", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_DIVMOD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "/MOD", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_1PLUS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "1+", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_1MINUS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "1-", addr);
     
     // Comparisons extended
-    addr = vm->here;
-    emit_byte(vm, OP_ZERO_EQ);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "0=", addr);
+    addr = img->here;
+    emit_byte(img, OP_ZERO_EQ);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "0=", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_ZERO_LT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "0<", addr);
+    addr = img->here;
+    emit_byte(img, OP_ZERO_LT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "0<", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_ZERO_NE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "0<>", addr);
+    addr = img->here;
+    emit_byte(img, OP_ZERO_NE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "0<>", addr);
     
     // Stack extended
-    addr = vm->here;
-    emit_byte(vm, OP_QDUP);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "?DUP", addr);
+    addr = img->here;
+    emit_byte(img, OP_QDUP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "?DUP", addr);
     
     // Memory extended
-    addr = vm->here;
-    emit_byte(vm, OP_PLUSSTORE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "+!", addr);
+    addr = img->here;
+    emit_byte(img, OP_PLUSSTORE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "+!", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_ALLOT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "ALLOT", addr);
+    addr = img->here;
+    emit_byte(img, OP_ALLOT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ALLOT", addr);
     
     // I/O
-    addr = vm->here;
-    emit_byte(vm, OP_EMIT);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "EMIT", addr);
+    addr = img->here;
+    emit_byte(img, OP_EMIT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "EMIT", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_KEY);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "KEY", addr);
+    addr = img->here;
+    emit_byte(img, OP_KEY);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "KEY", addr);
     
-    addr = vm->here;
-    emit_byte(vm, OP_CR);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "CR", addr);
+    addr = img->here;
+    emit_byte(img, OP_CR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CR", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_TYPE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "TYPE", addr);
     
     // Memory info
-    addr = vm->here;
-    emit_byte(vm, OP_HERE);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "HERE", addr);
+    addr = img->here;
+    emit_byte(img, OP_HERE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "HERE", addr);
     
     // Debug/Introspection
-    addr = vm->here;
-    emit_byte(vm, OP_DOT_S);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, ".S", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_DEPTH);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "DEPTH", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_CLEAR);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "CLEAR", addr);
-    
-    addr = vm->here;
-    emit_byte(vm, OP_WORDS);
-    emit_byte(vm, OP_EXIT);
-    add_word(vm, "WORDS", addr);
+    addr = img->here;
+    emit_byte(img, OP_DOT_S);
+    emit_byte(img, OP_EXIT);
+    add_word(img, ".S", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_DEPTH);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "DEPTH", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_CLEAR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CLEAR", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_WORDS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "WORDS", addr);
+    
+    // Multitasking
+    addr = img->here;
+    emit_byte(img, OP_PAUSE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "PAUSE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_KEYQ);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "KEY?", addr);
+    
+    // Atomics
+    addr = img->here;
+    emit_byte(img, OP_ATOMIC_LOAD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ATOMIC@", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ATOMIC_STORE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ATOMIC!", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ATOMIC_ADD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ATOMIC+!", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_CAS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CAS", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_FENCE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "FENCE", addr);
+    
+    // Heap
+    addr = img->here;
+    emit_byte(img, OP_ALLOCATE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ALLOCATE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_FREE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "FREE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_RESIZE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "RESIZE", addr);
+    
+    // Cells and alignment
+    addr = img->here;
+    emit_byte(img, OP_CELLS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CELLS", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_CELL_PLUS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CELL+", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ALIGNED);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ALIGNED", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ALIGN);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ALIGN", addr);
+    
+    // Bulk memory
+    addr = img->here;
+    emit_byte(img, OP_MOVE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "MOVE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_CMOVE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CMOVE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_CMOVE_UP);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "CMOVE>", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_FILL);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "FILL", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_ERASE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "ERASE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_COMPARE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "COMPARE", addr);
+    
+    // Double cells
+    addr = img->here;
+    emit_byte(img, OP_MSTAR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "M*", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_UMSTAR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "UM*", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_UMSLASHMOD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "UM/MOD", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_SMSLASHREM);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "SM/REM", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_DPLUS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "D+", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_DMINUS);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "D-", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_DDOT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "D.", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_INIT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG-INIT", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_STORE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG!", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_MULN);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG*N", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_ADD);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG+", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_MUL);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG*", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_DIVN);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG/N", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_COMPARE);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIGCOMPARE", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_TO_STR);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG>STR", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_BIG_DOT);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "BIG.", addr);
+    
+#ifdef FF_ENABLE_THREADS
+    // Channels
+    addr = img->here;
+    emit_byte(img, OP_SEND);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "SEND", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_RECV);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "RECV", addr);
+    
+    addr = img->here;
+    emit_byte(img, OP_TRY_RECV);
+    emit_byte(img, OP_EXIT);
+    add_word(img, "TRY-RECV", addr);
+#endif
     
     // Mark end of built-in words
-    vm->builtin_count = vm->word_count;
+    img->builtin_count = img->word_count;
+    img->words_low = img->word_count;
+    return img->here < img->dict_size && img->word_count < img->max_words;
+}
+
+static inline int init_forth(forth_t* vm) {
+    return init_forth_sized(vm, NULL);
+}
+
+// Release a VM's segments, its tasks' stacks and the channels it owns
+static void free_forth(forth_t* vm) {
+#ifdef FF_ENABLE_THREADS
+    forth_image_t* img = &vm->image;
+    for (int i = 0; i < img->channel_count; i++) {
+        if (img->channel_owned[i]) {
+            free_channel(img->channels[i]);
+            free(img->channels[i]);
+            img->channel_owned[i] = 0;
+        }
+    }
+#endif
+    free_image(&vm->image);
+    free_ctx(&vm->ctx);
+    for (int i = 0; i < FF_MAX_TASKS; i++) free_ctx(&vm->tasks[i]);
+}
+
+// Bytes a VM occupies: the struct and every segment it allocated
+static inline size_t forth_vm_bytes(const forth_t* vm) {
+    const forth_image_t* img = &vm->image;
+    size_t bytes = sizeof(*vm);
+#ifdef FF_ENABLE_SANDBOX
+    bytes += page_round((size_t)img->dict_size) + dirty_words(FF_SANDBOX_SPAN) * sizeof(uint64_t);
+#else
+    bytes += line_round(line_round((size_t)img->dict_size) +
+                        dirty_words(img->dict_size) * sizeof(uint64_t));
+#endif
+    bytes += line_round((size_t)img->max_words * sizeof(word_t));
+    if (img->calls) bytes += (size_t)img->dict_size * sizeof(uint32_t);
+    for (int i = -1; i < FF_MAX_TASKS; i++) {
+        const forth_ctx_t* c = i < 0 ? &vm->ctx : &vm->tasks[i];
+        if (c->ds) {
+#ifdef FF_ENABLE_SANDBOX
+            bytes += (size_t)(c->ds_size + c->rs_size) * sizeof(cell_t);
+#else
+            bytes += line_round(line_round((size_t)c->ds_size * sizeof(cell_t)) +
+                                (size_t)c->rs_size * sizeof(cell_t));
+#endif
+        }
+        if (c->heap) bytes += sizeof(forth_heap_t) + c->heap->size;
+    }
+    return bytes;
+}
+
+// VM pool: pre-initialized VMs cloned from a base VM (builtins plus any
+// prelude). Releasing a VM resets it to the base by restoring only what
+// the request touched: stacks, the dirty dictionary pages, word slots
+// from words_low up, and the image counters. The cost scales with the
+// work done, not with the dictionary size.
+typedef struct {
+    forth_t base;       // State every released VM returns to
+    forth_t* vms;       // count VMs in one allocation
+    forth_t** idle;     // Stack of VMs ready to hand out
+    int count;
+    int idle_count;
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_t lock;
+#endif
+} forth_vm_pool_t;
+
+// Give dst a copy of src's heap blocks (an empty heap if src has none).
+// 0 if out of memory.
+static int copy_heap(forth_ctx_t* dst, const forth_ctx_t* src) {
+    const forth_heap_t* from = src->heap;
+    if (!from || from->top == 0) {
+        heap_reset(dst->heap);
+        return 1;
+    }
+    forth_heap_t* h = ctx_heap(dst);
+    if (!h) return 0;
+    if (h->size < from->top) {
+        uint8_t* mem = realloc(h->mem, from->size);
+        if (!mem) return 0;
+        memset(mem + h->size, 0, from->size - h->size);
+        h->mem = mem;
+        h->size = from->size;
+    }
+    memcpy(h->mem, from->mem, from->top);
+    if (h->top > from->top) memset(h->mem + from->top, 0, h->top - from->top);
+    uint8_t* mem = h->mem;
+    uint32_t size = h->size;
+    *h = *from;
+    h->mem = mem;
+    h->size = size;
+    return 1;
+}
+
+// Copy a context's stacks and heap into new ones of the same depths
+static int clone_stacks(forth_ctx_t* dst, const forth_ctx_t* src) {
+    dst->heap = NULL;
+    dst->par = NULL;
+    if (!src->ds) {
+        dst->ds = dst->rs = NULL;
+        return 1;
+    }
+    if (!alloc_stacks(dst, src->ds_size, src->rs_size)) return 0;
+    memcpy(dst->ds, src->ds, (size_t)src->sp * sizeof(cell_t));
+    memcpy(dst->rs, src->rs, (size_t)src->rp * sizeof(cell_t));
+    return copy_heap(dst, src);
+}
+
+// Give the contexts of dst (a struct copy of src) stacks and heaps of
+// their own and point its task ring at them, all idle
+static int clone_contexts(forth_t* dst, const forth_t* src) {
+    dst->ctx.next = dst->ctx.current = &dst->ctx;
+    for (int i = 0; i < FF_MAX_TASKS; i++) {
+        dst->tasks[i].next = dst->tasks[i].current = &dst->tasks[i];
+        dst->tasks[i].ds = dst->tasks[i].rs = NULL;
+        dst->tasks[i].heap = NULL;
+        dst->tasks[i].par = NULL;
+    }
+    if (!clone_stacks(&dst->ctx, &src->ctx)) return 0;
+    for (int i = 0; i < src->task_count; i++) {
+        if (!clone_stacks(&dst->tasks[i], &src->tasks[i])) return 0;
+    }
+    return 1;
+}
+
+// Copy a VM into segments of its own, pointing its task ring at its own
+// contexts (all idle). 0 if out of memory; free_forth() releases dst
+// either way.
+static int clone_vm(forth_t* dst, const forth_t* src) {
+    memcpy(dst, src, sizeof(*dst));
+    if (!init_image(&dst->image, src->image.dict_size, src->image.max_words)) {
+        memset(dst, 0, sizeof(*dst));   // Nothing to free
+        return 0;
+    }
+    copy_image(&dst->image, &src->image);
+    memset(dst->image.dirty, 0, dirty_words(dst->image.dict_size) * sizeof(uint64_t));
+    dst->image.words_low = dst->image.word_count;
+#ifdef FF_ENABLE_THREADS
+    // The base keeps ownership of its channels; clones only share them
+    memset(dst->image.channel_owned, 0, sizeof(dst->image.channel_owned));
+#endif
+    return clone_contexts(dst, src);
+}
+
+// Return a clone of base to base's state. I/O callbacks and the PAR-DO
+// pool of the primary context are kept.
+static void reset_vm(forth_t* vm, const forth_t* base) {
+    forth_image_t* img = &vm->image;
+    const forth_image_t* orig = &base->image;
+    
+    size_t size = (size_t)img->dict_size;
+    for (size_t w = 0; w < dirty_words(img->dict_size); w++) {
+        uint64_t bits = img->dirty[w];
+        img->dirty[w] = 0;
+        while (bits) {
+            size_t off = (w * 64 + FF_CTZ64(bits)) << FF_PAGE_SHIFT;
+            size_t len = size - off < FF_PAGE_SIZE ? size - off : FF_PAGE_SIZE;
+            memcpy(&img->dict[off], &orig->dict[off], len);
+            bits &= bits - 1;
+        }
+    }
+    if (img->words_low < orig->word_count) {
+        memcpy(&img->words[img->words_low], &orig->words[img->words_low],
+               (orig->word_count - img->words_low) * sizeof(word_t));
+    }
+    img->words_low = orig->word_count;
+    if (img->calls && !orig->calls) {
+        free(img->calls);   // A request's PROFILE
+        img->calls = NULL;
+    }
+    img->here = orig->here;
+    img->word_count = orig->word_count;
+    img->builtin_count = orig->builtin_count;
+    img->data_here = orig->data_here;
+#ifdef FF_ENABLE_THREADS
+    for (int i = orig->channel_count; i < img->channel_count; i++) {
+        if (img->channel_owned[i]) {
+            free_channel(img->channels[i]);
+            free(img->channels[i]);
+            img->channel_owned[i] = 0;
+        }
+    }
+    img->channel_count = orig->channel_count;
+#endif
+    
+    // Tasks: unlink the ring and clear the private areas of base's tasks
+    // (later ones are rebuilt by TASK)
+    int tasks = vm->task_count < base->task_count ? vm->task_count : base->task_count;
+    for (int i = 0; i < tasks; i++) {
+        forth_ctx_t* task = &vm->tasks[i];
+        par_discard(task);
+        task->sp = task->rp = 0;
+        task->next = task->current = task;
+        memcpy(task->data, base->tasks[i].data, sizeof(task->data));
+        if (!copy_heap(task, &base->tasks[i])) heap_reset(task->heap);
+    }
+    vm->task_count = base->task_count;
+    
+    forth_ctx_t* ctx = &vm->ctx;
+    par_discard(ctx);
+    ctx->sp = ctx->rp = 0;
+    ctx->pc = 0;
+    ctx->next = ctx->current = ctx;
+    ctx->fuel = FF_FUEL_UNLIMITED;
+    ctx->interrupt = 0;
+    memcpy(ctx->data, base->ctx.data, sizeof(ctx->data));
+    if (!copy_heap(ctx, &base->ctx)) heap_reset(ctx->heap);
+    
+    vm->compiling = 0;
+    vm->csp = 0;
+}
+
+// Clone base into count VMs. base must have no active tasks.
+static inline int init_vm_pool(forth_vm_pool_t* pool, const forth_t* base, int count) {
+    memset(pool, 0, sizeof(*pool));
+    int ok = clone_vm(&pool->base, base);
+    pool->vms = calloc((size_t)count, sizeof(forth_t));
+    pool->idle = malloc(sizeof(forth_t*) * (size_t)count);
+    for (int i = 0; ok && pool->vms && pool->idle && i < count; i++) {
+        ok = clone_vm(&pool->vms[i], &pool->base);
+        pool->count = i + 1;
+        pool->idle[i] = &pool->vms[i];
+    }
+    if (!ok || !pool->vms || !pool->idle) {
+        for (int i = 0; i < pool->count; i++) free_forth(&pool->vms[i]);
+        free_forth(&pool->base);
+        free(pool->vms);
+        free(pool->idle);
+        return 0;
+    }
+    pool->idle_count = count;
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_init(&pool->lock, NULL);
+#endif
+    return 1;
+}
+
+static inline void free_vm_pool(forth_vm_pool_t* pool) {
+    for (int i = 0; i < pool->count; i++) {
+        free_forth(&pool->vms[i]);  // Also frees channels made by CHANNEL
+    }
+    free_forth(&pool->base);
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_destroy(&pool->lock);
+#endif
+    free(pool->vms);
+    free(pool->idle);
+}
+
+// Check out a ready VM, NULL if all are in use
+static inline forth_t* vm_pool_acquire(forth_vm_pool_t* pool) {
+    forth_t* vm = NULL;
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_lock(&pool->lock);
+#endif
+    if (pool->idle_count > 0) vm = pool->idle[--pool->idle_count];
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_unlock(&pool->lock);
+#endif
+    return vm;
+}
+
+// Reset a VM and hand it back
+static inline void vm_pool_release(forth_vm_pool_t* pool, forth_t* vm) {
+    reset_vm(vm, &pool->base);
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_lock(&pool->lock);
+#endif
+    pool->idle[pool->idle_count++] = vm;
+#ifdef FF_ENABLE_THREADS
+    pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+#ifdef FF_ENABLE_FORK
+// Copy-on-write forks: snapshot_vm() writes a VM's dictionary (with a
+// clean dirty bitmap) and word table to a shared memory file once; each
+// fork_vm() maps that file privately, so children share its pages until
+// they write to them, and only the pages they touch cost memory. The
+// snapshot also keeps the stacks, heaps and counters, so every child
+// starts from the same state. The parent is free to go on meanwhile.
+typedef struct {
+    forth_t vm;         // Everything but the image segments
+    int fd;
+    size_t size;        // File bytes
+    size_t words_at;    // Offset of the word table
+} forth_snapshot_t;
+
+// Snapshot vm, which must have no active tasks. 0 on failure;
+// free_snapshot() releases snap either way.
+static inline int snapshot_vm(forth_snapshot_t* snap, const forth_t* vm) {
+    const forth_image_t* img = &vm->image;
+    memcpy(&snap->vm, vm, sizeof(*vm));
+    forth_image_t* copy = &snap->vm.image;
+    copy->dict = NULL;
+    copy->words = NULL;
+    copy->dirty = NULL;
+    copy->calls = NULL;
+    copy->mapped = 0;
+    copy->words_low = copy->word_count;
+#ifdef FF_ENABLE_THREADS
+    memset(copy->channel_owned, 0, sizeof(copy->channel_owned));
+#endif
+    snap->fd = -1;
+    if (!clone_contexts(&snap->vm, vm)) return 0;
+    
+#ifdef FF_ENABLE_SANDBOX
+    snap->words_at = sandbox_window();
+#else
+    size_t dict_bytes = line_round((size_t)img->dict_size);
+    snap->words_at = page_round(dict_bytes + dirty_words(img->dict_size) * sizeof(uint64_t));
+#endif
+    snap->size = snap->words_at + page_round((size_t)img->max_words * sizeof(word_t));
+    
+    // An anonymous file: named only until it is opened
+    static _Atomic unsigned serial;
+    char name[64];
+    snprintf(name, sizeof(name), "/forth-snapshot-%ld-%u", (long)getpid(), serial++);
+    snap->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (snap->fd < 0) return 0;
+    shm_unlink(name);
+    size_t words_bytes = (size_t)img->word_count * sizeof(word_t);
+    return ftruncate(snap->fd, (off_t)snap->size) == 0 &&
+           pwrite(snap->fd, img->dict, (size_t)img->dict_size, 0) == img->dict_size &&
+           pwrite(snap->fd, img->words, words_bytes, (off_t)snap->words_at) == (ssize_t)words_bytes;
+}
+
+static inline void free_snapshot(forth_snapshot_t* snap) {
+    if (snap->fd >= 0) close(snap->fd);
+    snap->fd = -1;
+    free_ctx(&snap->vm.ctx);
+    for (int i = 0; i < FF_MAX_TASKS; i++) free_ctx(&snap->vm.tasks[i]);
+}
+
+// A child VM in the snapshot's state, its image mapped copy-on-write.
+// 0 if out of memory; free_forth() releases child either way.
+static inline int fork_vm(forth_t* child, const forth_snapshot_t* snap) {
+    memcpy(child, &snap->vm, sizeof(*child));
+    forth_image_t* img = &child->image;
+    if (!clone_contexts(child, &snap->vm)) return 0;
+    void* base = mmap(NULL, snap->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, snap->fd, 0);
+    if (base == MAP_FAILED) return 0;
+    img->dict = base;
+    img->words = (word_t*)(img->dict + snap->words_at);
+    img->mapped = snap->size;
+#ifdef FF_ENABLE_SANDBOX
+    // The mapping is the window followed by the word table
+    size_t usable = page_round((size_t)img->dict_size);
+    img->dirty = calloc(dirty_words(FF_SANDBOX_SPAN), sizeof(uint64_t));
+    return img->dirty && mprotect(img->dict + usable, snap->words_at - usable, PROT_NONE) == 0;
+#else
+    img->dirty = (uint64_t*)(img->dict + line_round((size_t)img->dict_size));
+    return 1;
+#endif
+}
+#endif // FF_ENABLE_FORK
+
+// Parallel loading (LOAD-PAR): independent files are compiled at the
+// same time, each into a clone of the VM, as a segment starting at the
+// current end of the dictionary. The linker then appends the segments
+// in the order the files were given: code is copied, logged operands
+// are moved, calls are bound by name to the words visible at that
+// point, and word tables are appended so later files shadow earlier
+// ones exactly as with LOAD. A file may call words of files before it
+// from inside definitions; it can't run them while loading, create
+// TASKs or CHANNELs, or store addresses it expects to be moved.
+typedef struct {
+    forth_t* vm;
+    const char** paths;
+    forth_t* units;         // One clone per file
+    forth_segment_t* segs;
+    int count;
+    int next;               // Next file to compile
+} forth_load_t;
+
+// Compile file i into its own clone of the VM
+static void load_unit(forth_load_t* job, int i) {
+    forth_t* unit = &job->units[i];
+    forth_segment_t* seg = &job->segs[i];
+    if (!clone_vm(unit, job->vm)) {
+        io_error(&job->vm->ctx, "Out of memory\n");
+        seg->failed = 1;
+        return;
+    }
+    seg->base = unit->image.here;
+    seg->base_words = unit->image.word_count;
+    seg->base_data = unit->image.data_here;
+    unit->seg = seg;
+#ifdef FF_ENABLE_THREADS
+    unit->ctx.pool = NULL;  // Already on a worker
+#endif
+    
+    forth_ctx_t* ctx = &unit->ctx;
+    FILE* fp = ctx->io.fopen_fn(job->paths[i], "r");
+    if (!fp) {
+        io_error(&job->vm->ctx, "Cannot open %s\n", job->paths[i]);
+        seg->failed = 1;
+        return;
+    }
+    char line[256];
+    while (!seg->failed && ctx->io.fgets_fn(line, sizeof(line), fp)) {
+        if (!interpret_line(unit, line)) seg->failed = 1;
+    }
+    ctx->io.fclose_fn(fp);
+    if (!seg->failed && unit->compiling) {
+        io_error(&job->vm->ctx, "Unterminated definition in %s\n", job->paths[i]);
+        seg->failed = 1;
+    }
+}
+
+static void load_units(forth_load_t* job) {
+    int i;
+    while ((i = ATOMIC_ADD(&job->next, 1)) < job->count) {
+        load_unit(job, i);
+    }
+}
+
+#ifdef FF_ENABLE_THREADS
+static void load_job(forth_pool_t* pool, int worker, void* arg) {
+    (void)pool;
+    (void)worker;
+    load_units(arg);
+}
+#endif
+
+// Append segment i to vm. orig is vm's dictionary before the segments
+// were compiled: bytes a file changed there (stores into existing
+// variables while loading) are carried over, later files winning.
+static int link_unit(forth_t* vm, forth_load_t* job, int i, const uint8_t* orig) {
+    forth_image_t* img = &vm->image;
+    forth_t* unit = &job->units[i];
+    forth_image_t* src = &unit->image;
+    forth_segment_t* seg = &job->segs[i];
+    const char* path = job->paths[i];
+    
+    int tasks_made = unit->task_count != vm->task_count;
+#ifdef FF_ENABLE_THREADS
+    tasks_made |= src->channel_count != img->channel_count;
+#endif
+    if (tasks_made) {
+        io_error(&vm->ctx, "%s: TASK and CHANNEL need LOAD\n", path);
+        return 0;
+    }
+    int size = src->here - seg->base;
+    int words = src->word_count - seg->base_words;
+    int data = src->data_here - seg->base_data;
+    // Pad so the segment moves by whole cells: VARIABLE and CREATE
+    // data compiled aligned stays aligned
+    int pad = (int)((seg->base - img->here) & (sizeof(cell_t) - 1));
+    if (img->here + pad + size > img->dict_size || img->word_count + words > img->max_words ||
+        img->data_here + data > FF_DATA_SIZE) {
+        io_error(&vm->ctx, "%s: dictionary full\n", path);
+        return 0;
+    }
+    
+    for (int pg = 0; pg << FF_PAGE_SHIFT < seg->base; pg++) {
+        if (!(src->dirty[pg >> 6] & ((uint64_t)1 << (pg & 63)))) continue;
+        int end = (pg + 1) << FF_PAGE_SHIFT;
+        if (end > seg->base) end = seg->base;
+        for (int a = pg << FF_PAGE_SHIFT; a < end; a++) {
+            if (src->dict[a] == orig[a]) continue;
+            mark_dirty(img, a, 1);
+            img->dict[a] = src->dict[a];
+        }
+    }
+    
+    if (pad > 0) {
+        memset(&img->dict[img->here], 0, (size_t)pad);
+        mark_dirty(img, img->here, pad);
+    }
+    addr_t at = img->here + pad;
+    int delta = at - seg->base;
+    int data_delta = img->data_here - seg->base_data;
+    if (size > 0) {
+        memcpy(&img->dict[at], &src->dict[seg->base], (size_t)size);
+        mark_dirty(img, at, size);
+    }
+    
+    for (int r = 0; r < seg->reloc_count; r++) {
+        const forth_reloc_t* rel = &seg->relocs[r];
+        uint8_t* op = &img->dict[rel->at + delta];
+        uint64_t v = 0;
+        for (int b = 0; b < rel->size; b++) v |= (uint64_t)op[b] << (8 * b);
+        switch (rel->kind) {
+            case FF_RELOC_ADDR:
+                if (v >= seg->base) v += delta;
+                break;
+            case FF_RELOC_WORD:
+            case FF_RELOC_EXTERN: {
+                const char* name = rel->kind == FF_RELOC_WORD ?
+                    src->words[rel->ref].name : seg->externs[rel->ref];
+                word_t* w = find_word(img, name);
+                if (!w) {
+                    io_error(&vm->ctx, "%s: ? %s\n", path, name);
+                    return 0;
+                }
+                v = w->addr;
+                break;
+            }
+            case FF_RELOC_DATA:
+                if (v >= (uint64_t)(FF_DATA_BASE + seg->base_data)) v += data_delta;
+                break;
+        }
+        for (int b = 0; b < rel->size; b++) op[b] = (uint8_t)(v >> (8 * b));
+    }
+    
+    for (int w = seg->base_words; w < src->word_count; w++) {
+        word_t* nw = add_word(img, src->words[w].name, (addr_t)(src->words[w].addr + delta));
+        nw->flags = src->words[w].flags;
+    }
+    memcpy(&vm->ctx.data[img->data_here], &unit->ctx.data[seg->base_data], (size_t)data);
+    img->here = at + size;
+    img->data_here += data;
+    return 1;
+}
+
+// Load files compiled in parallel on vm's pool (in turn without one).
+// Files before the first one that fails are kept, as with LOAD.
+static int load_parallel(forth_t* vm, const char** paths, int count) {
+    forth_load_t job;
+    memset(&job, 0, sizeof(job));
+    job.vm = vm;
+    job.paths = paths;
+    job.count = count;
+    job.units = calloc((size_t)count, sizeof(forth_t));
+    job.segs = calloc((size_t)count, sizeof(forth_segment_t));
+    uint8_t* orig = malloc((size_t)vm->image.here + 1);
+    int ready = job.units && job.segs && orig;
+    int ok = ready;
+    
+    if (ok) {
+        memcpy(orig, vm->image.dict, vm->image.here);
+#ifdef FF_ENABLE_THREADS
+        if (vm->ctx.pool) {
+            pool_run(vm->ctx.pool, load_job, &job);
+        } else {
+            load_units(&job);
+        }
+#else
+        load_units(&job);
+#endif
+        int relocs = 0, externs = 0;
+        for (int i = 0; i < count && ok; i++) {
+            ok = !job.segs[i].failed && link_unit(vm, &job, i, orig);
+            if (ok) {
+                relocs += job.segs[i].reloc_count;
+                externs += job.segs[i].extern_count;
+                io_printf(&vm->ctx, "Loaded %s\n", paths[i]);
+            }
+        }
+        if (ok) {
+            io_printf(&vm->ctx, "Linked %d files: %d relocations, %d cross-file calls\n",
+                                count, relocs, externs);
+        }
+    } else {
+        io_error(&vm->ctx, "Out of memory\n");
+    }
+    
+    for (int i = 0; ready && i < count; i++) {
+        free_forth(&job.units[i]);  // With any channels a failed file created
+        free(job.segs[i].relocs);
+        free(job.segs[i].externs);
+    }
+    free(orig);
+    free(job.segs);
+    free(job.units);
+    return ok;
+}
+
+// Profile-driven relayout (RELAYOUT, and SAVEB after PROFILE). Words
+// are compiled in definition order, so hot code ends up scattered among
+// VARIABLE cells, ALLOTed buffers, inline ." strings and cold words.
+// Relayout packs the most-called words together right after the
+// builtins, then the cold ones, then the strings taken out of line, and
+// rewrites every call, branch and string address. Data (whatever lies
+// between definitions) stays put, since programs hold its addresses as
+// plain numbers, and so does any word whose address appears as a
+// number in the dictionary, the USER areas or on the stack (an xt from
+// ', a CONSTANT). xts held by the host go stale: look words up again.
+typedef struct {
+    addr_t start, end;      // Code, inline strings included
+    addr_t at;              // New address
+    int len;                // New length, strings taken out
+    uint32_t calls;
+    int pinned;
+    int op, op_end;         // Its address operands in forth_layout_t.ops
+    int str, str_end;       // Its ." strings
+} forth_span_t;
+
+typedef struct {
+    addr_t at;              // Operand location
+    uint8_t size;           // 2 or sizeof(cell_t)
+} forth_operand_t;
+
+typedef struct {
+    addr_t branch;          // BRANCH over the text
+    addr_t text;
+    int len;
+    addr_t at;              // New address of the text
+} forth_string_t;
+
+typedef struct {
+    forth_span_t* spans;    // By start address
+    int span_count;
+    forth_operand_t* ops;
+    int op_count;
+    forth_string_t* strs;
+    int str_count;
+} forth_layout_t;
+
+// A word whose address is held as a number must not move
+static void layout_pin(forth_layout_t* L, cell_t v) {
+    int lo = 0, hi = L->span_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (L->spans[mid].start == v) {
+            L->spans[mid].pinned = 1;
+            return;
+        }
+        if (L->spans[mid].start < v) lo = mid + 1;
+        else hi = mid - 1;
+    }
+}
+
+// Whether BRANCH text -> end skips the text of a ." (LIT text LIT len TYPE)
+static int layout_string(forth_image_t* img, int text, int end, int limit) {
+    const int lit = 1 + (int)sizeof(cell_t);
+    if (end < text || end + 2 * lit + 1 > limit) return 0;
+    return img->dict[end] == OP_LIT && img->dict[end + lit] == OP_LIT &&
+           img->dict[end + 2 * lit] == OP_TYPE &&
+           load_cell(&img->dict[end + 1]) == text &&
+           load_cell(&img->dict[end + lit + 1]) == end - text;
+}
+
+// Decode the definition at s->start, which must end before limit: log
+// its address operands and strings, and pin the words its literals
+// name. 0 if it isn't plain compiled code.
+static int layout_decode(forth_image_t* img, forth_layout_t* L, forth_span_t* s, int limit) {
+    const int lit = 1 + (int)sizeof(cell_t);
+    int pc = s->start;
+    int fwd = s->start;     // Furthest forward branch target
+    s->op = L->op_count;
+    s->str = L->str_count;
+    while (pc < limit) {
+        uint8_t op = img->dict[pc];
+        int len = op == OP_LIT ? lit : op == OP_PAR_DO ? 4 :
+                  op == OP_CALL || op == OP_BRANCH || op == OP_BRANCH_IF_ZERO ||
+                  op == OP_LOOP ? 3 : 1;
+        int next = pc + len;
+        if (op >= OP_MAX || next > limit) return 0;
+        if (op == OP_EXIT && next > fwd) {
+            s->end = (addr_t)next;
+            s->op_end = L->op_count;
+            s->str_end = L->str_count;
+            return 1;
+        }
+        if (op == OP_LIT) {
+            layout_pin(L, load_cell(&img->dict[pc + 1]));
+        } else if (len >= 3) {
+            int target = img->dict[next - 2] | img->dict[next - 1] << 8;
+            if (op == OP_BRANCH && layout_string(img, next, target, limit)) {
+                forth_string_t* str = &L->strs[L->str_count++];
+                str->branch = (addr_t)pc;
+                str->text = (addr_t)next;
+                str->len = target - next;
+                L->ops[L->op_count++] = (forth_operand_t){ (addr_t)(target + 1), sizeof(cell_t) };
+                pc = target + 2 * lit;  // At the TYPE
+                continue;
+            }
+            if (op != OP_CALL) {
+                if (target < s->start) return 0;
+                if (target > fwd) fwd = target;
+            }
+            L->ops[L->op_count++] = (forth_operand_t){ (addr_t)(next - 2), 2 };
+        }
+        pc = next;
+    }
+    return 0;
+}
+
+// Lowest free run of len bytes from lo, marked taken; -1 if none. Hot
+// code that fits in a cache line is kept from straddling two if it can.
+static int layout_place(uint8_t* taken, int size, int lo, int len, int hot) {
+    for (int pass = hot && len <= FF_CACHE_LINE ? 0 : 1; pass < 2; pass++) {
+        int run = 0;
+        for (int a = lo; a < size; a++) {
+            run = taken[a] ? 0 : run + 1;
+            if (pass == 0 && run > 0 && (a + 1 - run) / FF_CACHE_LINE != a / FF_CACHE_LINE) {
+                run = a % FF_CACHE_LINE + 1;    // Start over at the line
+            }
+            if (run == len) {
+                memset(&taken[a + 1 - len], 1, (size_t)len);
+                return a + 1 - len;
+            }
+        }
+    }
+    return -1;
+}
+
+// Cache-miss proxy: lines holding executed code, and line fetches if
+// each call brings in every line of its word once
+static void layout_cost(forth_image_t* img, forth_layout_t* L, int after,
+                        int* lines, uint64_t* fetches) {
+    uint8_t seen[FF_DICT_MAX / FF_CACHE_LINE + 1];
+    memset(seen, 0, sizeof(seen));
+    *lines = 0;
+    *fetches = 0;
+    for (int i = 0; i < img->builtin_count + L->span_count; i++) {
+        int start, end;
+        uint32_t calls;
+        if (i < img->builtin_count) {
+            start = img->words[i].addr;
+            end = start + 2;
+            calls = img->calls[start];
+        } else {
+            forth_span_t* s = &L->spans[i - img->builtin_count];
+            int moved = after && !s->pinned;
+            start = moved ? s->at : s->start;
+            end = moved ? s->at + s->len : s->end;
+            calls = s->calls;
+        }
+        if (!calls || end <= start) continue;
+        for (int line = start / FF_CACHE_LINE; line <= (end - 1) / FF_CACHE_LINE; line++) {
+            *lines += !seen[line];
+            seen[line] = 1;
+            *fetches += calls;
+        }
+    }
+}
+
+static int span_cmp(const void* a, const void* b) {
+    const forth_span_t* x = a;
+    const forth_span_t* y = b;
+    return (int)x->start - (int)y->start;
+}
+
+// Hottest first, then in definition order
+static int span_heat_cmp(const void* a, const void* b) {
+    const forth_span_t* x = *(forth_span_t* const*)a;
+    const forth_span_t* y = *(forth_span_t* const*)b;
+    if (x->calls != y->calls) return x->calls > y->calls ? -1 : 1;
+    return (int)x->start - (int)y->start;
+}
+
+// Relayout vm's dictionary by its call counts (definition order without
+// PROFILE) and report the cache-line cost before and after. Nothing
+// changes unless it succeeds.
+static int relayout(forth_t* vm) {
+    forth_image_t* img = &vm->image;
+    if (vm->compiling || vm->seg || vm->ctx.next != &vm->ctx) {
+        io_error(&vm->ctx, "RELAYOUT needs no definition or task in progress\n");
+        return 0;
+    }
+    for (int i = 0; i < img->word_count; i++) {
+        if (img->words[i].flags & FF_WORD_MARKER) {
+            io_error(&vm->ctx, "RELAYOUT would move %s's restore point: forget it first\n",
+                    img->words[i].name);
+            return 0;
+        }
+    }
+    int lo = 0;     // Builtins stay at the front
+    for (int i = 0; i < img->builtin_count; i++) {
+        if (img->words[i].addr + 2 > lo) lo = img->words[i].addr + 2;
+    }
+    int here = img->here;
+    int size = img->dict_size;
+    forth_layout_t L;
+    memset(&L, 0, sizeof(L));
+    L.spans = calloc((size_t)img->word_count + 1, sizeof(forth_span_t));
+    L.ops = malloc(sizeof(forth_operand_t) * (size_t)(here / 3 + 1));
+    L.strs = malloc(sizeof(forth_string_t) * (size_t)(here / 3 + 1));
+    forth_span_t** order = malloc(sizeof(forth_span_t*) * ((size_t)img->word_count + 1));
+    addr_t* map = malloc(sizeof(addr_t) * (size_t)(here + 1));
+    uint8_t* taken = calloc((size_t)size, 1);
+    uint8_t* dict = calloc((size_t)size, 1);
+    uint32_t* calls = img->calls ? calloc((size_t)size, sizeof(uint32_t)) : NULL;
+    int ok = L.spans && L.ops && L.strs && order && map && taken && dict &&
+             (calls || !img->calls);
+    if (!ok) io_error(&vm->ctx, "Out of memory\n");
+    
+    // One span per definition, shadowed ones included
+    for (int i = img->builtin_count; ok && i < img->word_count; i++) {
+        addr_t a = img->words[i].addr;
+        if (a >= lo && a < here) L.spans[L.span_count++].start = a;
+    }
+    if (ok) qsort(L.spans, (size_t)L.span_count, sizeof(forth_span_t), span_cmp);
+    int n = 0;
+    for (int i = 0; i < L.span_count; i++) {
+        if (n == 0 || L.spans[n - 1].start != L.spans[i].start) L.spans[n++] = L.spans[i];
+    }
+    L.span_count = n;
+    for (int i = 0; ok && i < n; i++) {
+        forth_span_t* s = &L.spans[i];
+        if (!layout_decode(img, &L, s, i + 1 < n ? L.spans[i + 1].start : here)) {
+            io_error(&vm->ctx, "RELAYOUT: the word at %d is not plain code\n", s->start);
+            ok = 0;
+        }
+        s->calls = img->calls ? img->calls[s->start] : 0;
+    }
+    
+    // Builtins and the data between definitions are fixed; numbers
+    // stored there, in the USER areas or on the stack may be xts
+    if (ok) {
+        memset(taken, 1, (size_t)lo);
+        for (int i = 0, a = lo; a < here; i++) {
+            int gap_end = i < n ? L.spans[i].start : here;
+            memset(&taken[a], 1, (size_t)(gap_end - a));
+            int c = (a + (int)sizeof(cell_t) - 1) & ~((int)sizeof(cell_t) - 1);
+            for (; c + (int)sizeof(cell_t) <= gap_end; c += sizeof(cell_t)) {
+                layout_pin(&L, load_cell(&img->dict[c]));
+            }
+            a = i < n ? L.spans[i].end : here;
+        }
+        for (int t = -1; t < vm->task_count; t++) {
+            const forth_ctx_t* c = t < 0 ? &vm->ctx : &vm->tasks[t];
+            for (int i = 0; i + (int)sizeof(cell_t) <= FF_DATA_SIZE; i += sizeof(cell_t)) {
+                layout_pin(&L, load_cell(&c->data[i]));
+            }
+            for (uint32_t i = 0; c->heap && i + sizeof(cell_t) <= c->heap->top; i += sizeof(cell_t)) {
+                layout_pin(&L, load_cell(&c->heap->mem[i]));
+            }
+        }
+        for (int i = 0; i < vm->ctx.sp; i++) layout_pin(&L, vm->ctx.ds[i]);
+    }
+    
+    // Place hot words, then cold ones, then their strings
+    int moved = 0, hot = 0, pinned = 0, strings = 0;
+    for (int i = 0; ok && i < n; i++) {
+        forth_span_t* s = &L.spans[i];
+        s->len = s->end - s->start;
+        if (s->pinned) {
+            memset(&taken[s->start], 1, (size_t)s->len);
+            s->at = s->start;
+            pinned++;
+            continue;
+        }
+        for (int k = s->str; k < s->str_end; k++) s->len -= 3 + L.strs[k].len;
+        order[moved++] = s;
+        hot += s->calls > 0;
+    }
+    if (ok) qsort(order, (size_t)moved, sizeof(forth_span_t*), span_heat_cmp);
+    int full = 0;
+    for (int i = 0; ok && !full && i < moved; i++) {
+        int at = layout_place(taken, size, lo, order[i]->len, order[i]->calls > 0);
+        full = at < 0;
+        order[i]->at = (addr_t)at;
+    }
+    for (int i = 0; ok && !full && i < moved; i++) {
+        for (int k = order[i]->str; !full && k < order[i]->str_end; k++) {
+            forth_string_t* str = &L.strs[k];
+            if (str->len == 0) continue;
+            int at = layout_place(taken, size, lo, str->len, 0);
+            full = at < 0;
+            str->at = (addr_t)at;
+            strings++;
+        }
+    }
+    if (full) {
+        io_error(&vm->ctx, "RELAYOUT: dictionary full\n");
+        ok = 0;
+    }
+    
+    if (ok) {
+        // Build the new dictionary, mapping every moved byte
+        memcpy(dict, img->dict, (size_t)here);
+        for (int a = 0; a <= here; a++) map[a] = (addr_t)a;
+        for (int i = 0; i < moved; i++) {
+            memset(&dict[order[i]->start], 0, (size_t)(order[i]->end - order[i]->start));
+        }
+        for (int i = 0; i < moved; i++) {
+            forth_span_t* s = order[i];
+            int to = s->at, k = s->str;
+            for (int a = s->start; a < s->end; ) {
+                if (k < s->str_end && a == L.strs[k].branch) {
+                    // The BRANCH over the text goes; code falls through to the LIT
+                    forth_string_t* str = &L.strs[k++];
+                    for (int b = 0; b < str->len; b++) {
+                        dict[str->at + b] = img->dict[str->text + b];
+                        map[str->text + b] = (addr_t)(str->at + b);
+                    }
+                    map[a] = map[a + 1] = map[a + 2] = (addr_t)to;
+                    a = str->text + str->len;
+                    continue;
+                }
+                dict[to] = img->dict[a];
+                map[a++] = (addr_t)to++;
+            }
+        }
+        for (int i = 0; i < L.op_count; i++) {
+            const forth_operand_t* o = &L.ops[i];
+            ucell_t v = 0;
+            for (int b = 0; b < o->size; b++) v |= (ucell_t)img->dict[o->at + b] << (8 * b);
+            if (v <= (ucell_t)here) v = map[v];
+            for (int b = 0; b < o->size; b++) dict[map[o->at] + b] = (uint8_t)(v >> (8 * b));
+        }
+        
+        int new_here = size;
+        while (new_here > lo && !taken[new_here - 1]) new_here--;
+        int end = new_here > here ? new_here : here;
+        if (img->calls) {
+            int lines[2];
+            uint64_t fetches[2];
+            layout_cost(img, &L, 0, &lines[0], &fetches[0]);
+            layout_cost(img, &L, 1, &lines[1], &fetches[1]);
+            io_printf(&vm->ctx, "Relayout: %d words moved (%d hot), %d pinned, %d strings out of line\n",
+                                moved, hot, pinned, strings);
+            io_printf(&vm->ctx, "Cache lines of executed code: %d -> %d, line fetches: %llu -> %llu\n",
+                                lines[0], lines[1], (unsigned long long)fetches[0],
+                                (unsigned long long)fetches[1]);
+            for (int a = 0; a < here; a++) calls[map[a]] += img->calls[a];
+            free(img->calls);
+            img->calls = calls;
+            calls = NULL;
+        } else {
+            io_printf(&vm->ctx, "Relayout: %d words moved, %d pinned, %d strings out of line "
+                                "(no call counts: PROFILE first)\n", moved, pinned, strings);
+        }
+        memcpy(&img->dict[lo], &dict[lo], (size_t)(end - lo));
+        if (end > lo) mark_dirty(img, lo, end - lo);
+        for (int i = img->builtin_count; i < img->word_count; i++) {
+            if (img->words[i].addr >= lo && img->words[i].addr < here) {
+                img->words[i].addr = map[img->words[i].addr];
+            }
+        }
+        if (img->builtin_count < img->words_low) img->words_low = img->builtin_count;
+        img->here = (addr_t)new_here;
+    }
+    
+    free(calls);
+    free(dict);
+    free(taken);
+    free(map);
+    free(order);
+    free(L.strs);
+    free(L.ops);
+    free(L.spans);
+    return ok;
+}
+
+#ifdef FF_ENABLE_THREADS
+// RCU-published image: threads execute on the published image without
+// locks while a writer compiles into a private copy and publishes it
+// with one pointer swap. Readers announce the epoch they started in;
+// a replaced image is freed once every active reader started after it
+// was replaced, so nobody can still be running its code.
+//
+// Each update copies the dictionary, so data kept in it (VARIABLE) is
+// carried over as of the update; writes racing with an update can be
+// lost. Keep per-thread state in USER variables.
+#ifndef FF_RCU_READERS
+#define FF_RCU_READERS 64
+#endif
+
+typedef struct forth_retired forth_retired_t;
+struct forth_retired {
+    forth_image_t* image;
+    uint64_t epoch;         // Free once no reader started before this
+    forth_retired_t* next;
+};
+
+typedef struct {
+    _Atomic(forth_image_t*) image;  // Published image
+    _Atomic uint64_t epoch;
+    struct {
+        _Atomic uint64_t epoch;     // Epoch entered, 0 while outside
+        _Atomic int used;           // Slot held by a registered thread
+        char pad[64 - sizeof(uint64_t) - sizeof(int)];
+    } readers[FF_RCU_READERS];
+    
+    // Writers are serialized; writer.image is the private copy
+    pthread_mutex_t write_lock;
+    forth_t writer;
+    forth_retired_t* retired;
+    long updates;
+    long reclaimed;
+} forth_rcu_t;
+
+// Publish a copy of vm's image
+static inline int init_rcu(forth_rcu_t* rcu, const forth_t* vm) {
+    memset(rcu, 0, sizeof(*rcu));
+    forth_image_t* img = malloc(sizeof(*img));
+    if (!img || !init_image(img, vm->image.dict_size, vm->image.max_words)) {
+        free(img);
+        return 0;
+    }
+    copy_image(img, &vm->image);
+    memset(img->channel_owned, 0, sizeof(img->channel_owned));  // vm keeps them
+    forth_t* w = &rcu->writer;
+    int ok = clone_vm(w, vm);
+    free_ctx(&w->ctx);
+    if (!ok || !init_ctx_sized(&w->ctx, vm->ctx.ds_size, vm->ctx.rs_size)) {
+        free_forth(w);
+        free_image(img);
+        free(img);
+        return 0;
+    }
+    w->task_count = 0;
+    atomic_init(&rcu->image, img);
+    atomic_init(&rcu->epoch, 1);
+    pthread_mutex_init(&rcu->write_lock, NULL);
+    return 1;
+}
+
+static inline void rcu_free_image(forth_image_t* img) {
+    free_image(img);
+    free(img);
+}
+
+// Reader slot for the calling thread, -1 if all are taken. Threads
+// that stop reading hand theirs back with rcu_unregister().
+static inline int rcu_register(forth_rcu_t* rcu) {
+    for (int id = 0; id < FF_RCU_READERS; id++) {
+        int free_slot = 0;
+        if (atomic_compare_exchange_strong(&rcu->readers[id].used, &free_slot, 1)) return id;
+    }
+    return -1;
+}
+
+// Release a slot from rcu_register(); the thread must be outside
+// rcu_read_lock()
+static inline void rcu_unregister(forth_rcu_t* rcu, int id) {
+    atomic_store(&rcu->readers[id].epoch, 0);
+    atomic_store_explicit(&rcu->readers[id].used, 0, memory_order_release);
+}
+
+static inline forth_image_t* rcu_read_lock(forth_rcu_t* rcu, int id) {
+    atomic_store(&rcu->readers[id].epoch, atomic_load(&rcu->epoch));
+    return atomic_load(&rcu->image);
+}
+
+static inline void rcu_read_unlock(forth_rcu_t* rcu, int id) {
+    atomic_store_explicit(&rcu->readers[id].epoch, 0, memory_order_release);
+}
+
+// Free replaced images no reader can still hold (write lock held)
+static inline void rcu_reclaim(forth_rcu_t* rcu) {
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < FF_RCU_READERS; i++) {
+        uint64_t e = atomic_load(&rcu->readers[i].epoch);
+        if (e && e < oldest) oldest = e;
+    }
+    forth_retired_t** link = &rcu->retired;
+    while (*link) {
+        forth_retired_t* r = *link;
+        if (r->epoch <= oldest) {
+            *link = r->next;
+            rcu_free_image(r->image);
+            free(r);
+            rcu->reclaimed++;
+        } else {
+            link = &r->next;
+        }
+    }
+}
+
+// Compile source against a private copy of the published image, then
+// publish it. Nothing is published if compilation fails.
+static inline int rcu_update(forth_rcu_t* rcu, const char* source) {
+    pthread_mutex_lock(&rcu->write_lock);
+    forth_t* w = &rcu->writer;
+    forth_image_t* old = atomic_load(&rcu->image);
+    copy_image(&w->image, old);
+    int ok = interpret_line(w, source) && !w->compiling;
+    forth_image_t* fresh = ok ? malloc(sizeof(*fresh)) : NULL;
+    if (fresh && !init_image(fresh, w->image.dict_size, w->image.max_words)) {
+        free(fresh);
+        fresh = NULL;
+    }
+    forth_retired_t* r = fresh ? malloc(sizeof(*r)) : NULL;
+    if (!r) {
+        if (fresh) rcu_free_image(fresh);
+        w->compiling = 0;
+        w->csp = 0;
+        pthread_mutex_unlock(&rcu->write_lock);
+        return 0;
+    }
+    copy_image(fresh, &w->image);
+    atomic_store(&rcu->image, fresh);
+    r->image = old;
+    r->epoch = atomic_fetch_add(&rcu->epoch, 1) + 1;
+    r->next = rcu->retired;
+    rcu->retired = r;
+    rcu->updates++;
+    rcu_reclaim(rcu);
+    pthread_mutex_unlock(&rcu->write_lock);
+    return 1;
+}
+
+// No readers may be active
+static inline void free_rcu(forth_rcu_t* rcu) {
+    while (rcu->retired) {
+        forth_retired_t* r = rcu->retired;
+        rcu->retired = r->next;
+        rcu_free_image(r->image);
+        free(r);
+    }
+    rcu_free_image(atomic_load(&rcu->image));
+    free_forth(&rcu->writer);
+    pthread_mutex_destroy(&rcu->write_lock);
 }
+#endif // FF_ENABLE_THREADS
 
 // REPL
 #ifdef FF_ENABLE_REPL
@@ -0,0 +1,408 @@
+// Evaluation server: Forth requests over a Unix domain socket
+// One epoll thread owns all connections; worker threads evaluate the
+// requests on VMs from a pool cloned from a preloaded base VM, so each
+// request starts from the same image and leaves nothing behind.
+//
+// Protocol, one request per line, answered in order per connection:
+//   request:  <forth source>\n
+//   response: <status> <outlen> <depth> <cell> ... <cell>\n<outlen bytes>
+// status is ok, error (unknown word, failed word, unfinished
+// definition, or SEND/RECV on a channel that is not ready) or fuel
+// (ran past FF_SERVE_FUEL). The cells are the data
+// stack bottom first, the bytes the captured output, diagnostics
+// included. BYE, QUIT and EXIT end the request, not the server.
+#ifndef FORTH_SERVER_H
+#define FORTH_SERVER_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "forth_fast.h"
+
+#ifndef FF_SERVE_LINE
+#define FF_SERVE_LINE 1024          // Longest request line
+#endif
+#ifndef FF_SERVE_OUTPUT
+#define FF_SERVE_OUTPUT 4096        // Captured output per request, the rest is dropped
+#endif
+#ifndef FF_SERVE_FUEL
+#define FF_SERVE_FUEL 100000000     // Safepoints a request may pass
+#endif
+#define FF_SERVE_REPLY (64 + FF_STACK_DEPTH * 12 + FF_SERVE_OUTPUT)
+
+typedef struct serve_conn serve_conn_t;
+struct serve_conn {
+    int fd;
+    int busy;       // A worker owns request/reply
+    int closed;     // Peer went away; free once not busy
+    int eof;        // Peer sent all its input; free once answered
+    uint32_t events;    // Epoll interest; ~0 once removed from epoll
+    
+    // Input not yet dispatched, and the request being evaluated
+    char in[FF_SERVE_LINE];
+    size_t in_len;
+    char request[FF_SERVE_LINE];
+    
+    // Reply written by the worker, and output waiting for the socket
+    char reply[FF_SERVE_REPLY];
+    size_t reply_len;
+    char* out;
+    size_t out_len, out_sent, out_cap;
+    
+    serve_conn_t* next_job;           // Work or done queue
+    serve_conn_t* prev;               // All connections
+    serve_conn_t* next;
+};
+
+typedef struct {
+    forth_vm_pool_t vms;
+    int listen_fd;
+    int epoll_fd;
+    int event_fd;   // Workers wake the event loop through this
+    
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    serve_conn_t* queue_head;
+    serve_conn_t* queue_tail;
+    serve_conn_t* done;
+    int stopping;
+    
+    serve_conn_t* conns;
+} forth_server_t;
+
+// Output capture: each worker points this at its current reply
+static _Thread_local char* serve_out;
+static _Thread_local size_t serve_out_len;
+
+static void serve_putchar(int c) {
+    if (serve_out_len < FF_SERVE_OUTPUT) serve_out[serve_out_len++] = (char)c;
+}
+
+// Diagnostics (unknown words and the like) go to the client too
+static void serve_error(const char* msg) {
+    while (*msg) serve_putchar((unsigned char)*msg++);
+}
+
+// Evaluate conn->request on a pooled VM and format conn->reply
+static void serve_eval(forth_server_t* srv, serve_conn_t* conn, char* output) {
+    forth_t* vm = vm_pool_acquire(&srv->vms);  // One VM per worker, never NULL
+    vm->ctx.fuel = FF_SERVE_FUEL;
+    serve_out = output;
+    serve_out_len = 0;
+    
+    int ok = interpret_line(vm, conn->request) && !vm->compiling;
+    const char* status = ok ? "ok" : vm->ctx.fuel <= 0 ? "fuel" : "error";
+    
+    char* r = conn->reply;
+    size_t room = sizeof(conn->reply) - serve_out_len - 1;  // Leaves space for the newline
+    int n = snprintf(r, room, "%s %zu %d", status, serve_out_len, vm->ctx.sp);
+    // Room for a default-depth stack; deeper ones are cut short
+    for (int i = 0; i < vm->ctx.sp && (size_t)n < room; i++) {
+        n += snprintf(r + n, room - n, " %lld", (long long)vm->ctx.ds[i]);
+    }
+    if ((size_t)n >= room) n = (int)room - 1;
+    r[n++] = '\n';
+    memcpy(r + n, output, serve_out_len);
+    conn->reply_len = n + serve_out_len;
+    
+    vm_pool_release(&srv->vms, vm);
+}
+
+static void* serve_worker(void* arg) {
+    forth_server_t* srv = arg;
+    char output[FF_SERVE_OUTPUT];
+    
+    for (;;) {
+        pthread_mutex_lock(&srv->lock);
+        while (!srv->queue_head && !srv->stopping) {
+            pthread_cond_wait(&srv->ready, &srv->lock);
+        }
+        serve_conn_t* conn = srv->queue_head;
+        if (!conn) {
+            pthread_mutex_unlock(&srv->lock);
+            break;
+        }
+        srv->queue_head = conn->next_job;
+        if (!srv->queue_head) srv->queue_tail = NULL;
+        pthread_mutex_unlock(&srv->lock);
+        
+        serve_eval(srv, conn, output);
+        
+        pthread_mutex_lock(&srv->lock);
+        conn->next_job = srv->done;
+        srv->done = conn;
+        pthread_mutex_unlock(&srv->lock);
+        uint64_t one = 1;
+        ssize_t w = write(srv->event_fd, &one, sizeof(one));
+        (void)w;
+    }
+    return NULL;
+}
+
+static void serve_close(forth_server_t* srv, serve_conn_t* conn) {
+    if (conn->events != ~0u) epoll_ctl(srv->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    if (conn->prev) conn->prev->next = conn->next;
+    else srv->conns = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+    free(conn->out);
+    free(conn);
+}
+
+// Write pending output
+static void serve_flush(serve_conn_t* conn) {
+    while (conn->out_sent < conn->out_len) {
+        ssize_t n = send(conn->fd, conn->out + conn->out_sent,
+                         conn->out_len - conn->out_sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) conn->closed = 1;
+            break;
+        }
+        conn->out_sent += (size_t)n;
+    }
+    if (conn->out_sent == conn->out_len) conn->out_sent = conn->out_len = 0;
+}
+
+// Watch for input only while it can be read (no request running, not
+// at end of input, room left) and for output while some is pending, so
+// a level-triggered fd never wakes the loop with nothing to do. Closed
+// connections leave epoll, as hangups are reported regardless.
+static void serve_watch(forth_server_t* srv, serve_conn_t* conn) {
+    if (conn->closed) {
+        if (conn->events != ~0u) epoll_ctl(srv->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        conn->events = ~0u;
+        return;
+    }
+    uint32_t events = (conn->out_len > 0 ? EPOLLOUT : 0) |
+        (!conn->busy && !conn->eof && conn->in_len < sizeof(conn->in) ? EPOLLIN : 0);
+    if (events != conn->events) {
+        struct epoll_event ev = { .events = events, .data.ptr = conn };
+        epoll_ctl(srv->epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+        conn->events = events;
+    }
+}
+
+static int serve_append(serve_conn_t* conn, const char* data, size_t len) {
+    if (conn->out_len + len > conn->out_cap) {
+        size_t cap = conn->out_cap ? conn->out_cap : FF_SERVE_REPLY;
+        while (cap < conn->out_len + len) cap *= 2;
+        char* out = realloc(conn->out, cap);
+        if (!out) return 0;
+        conn->out = out;
+        conn->out_cap = cap;
+    }
+    memcpy(conn->out + conn->out_len, data, len);
+    conn->out_len += len;
+    return 1;
+}
+
+// Hand the next complete line to the workers (one at a time per
+// connection, so replies come back in request order)
+static void serve_dispatch(forth_server_t* srv, serve_conn_t* conn) {
+    if (conn->busy || conn->closed) return;
+    char* nl = memchr(conn->in, '\n', conn->in_len);
+    size_t len, used;
+    if (nl) {
+        len = (size_t)(nl - conn->in);
+        used = len + 1;
+    } else if (conn->in_len == sizeof(conn->in)) {
+        conn->closed = 1;  // Line too long
+        return;
+    } else if (conn->eof && conn->in_len > 0) {
+        len = used = conn->in_len;  // Last line, without a newline
+    } else {
+        return;
+    }
+    memcpy(conn->request, conn->in, len);
+    if (len > 0 && conn->request[len - 1] == '\r') len--;
+    conn->request[len] = '\0';
+    conn->in_len -= used;
+    memmove(conn->in, conn->in + used, conn->in_len);
+    
+    conn->busy = 1;
+    conn->next_job = NULL;
+    pthread_mutex_lock(&srv->lock);
+    if (srv->queue_tail) srv->queue_tail->next_job = conn;
+    else srv->queue_head = conn;
+    srv->queue_tail = conn;
+    pthread_cond_signal(&srv->ready);
+    pthread_mutex_unlock(&srv->lock);
+}
+
+static void serve_accept(forth_server_t* srv) {
+    for (;;) {
+        int fd = accept(srv->listen_fd, NULL, NULL);
+        if (fd < 0) return;
+        serve_conn_t* conn = calloc(1, sizeof(*conn));
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = conn };
+        if (!conn || fcntl(fd, F_SETFL, O_NONBLOCK) < 0 ||
+            epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            free(conn);
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->events = EPOLLIN;
+        conn->next = srv->conns;
+        if (srv->conns) srv->conns->prev = conn;
+        srv->conns = conn;
+    }
+}
+
+static void serve_read(serve_conn_t* conn) {
+    while (conn->in_len < sizeof(conn->in)) {
+        ssize_t n = read(conn->fd, conn->in + conn->in_len, sizeof(conn->in) - conn->in_len);
+        if (n > 0) {
+            conn->in_len += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n == 0) {
+            conn->eof = 1;  // Half-closed: the buffered lines still get replies
+            break;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) conn->closed = 1;
+            break;
+        }
+    }
+}
+
+// Dispatch the next request, or free the connection once it is gone or
+// has been answered after end of input; then update its epoll interest
+static void serve_update(forth_server_t* srv, serve_conn_t* conn) {
+    serve_dispatch(srv, conn);
+    if (!conn->busy && (conn->closed || (conn->eof && conn->out_len == 0))) {
+        serve_close(srv, conn);
+    } else {
+        serve_watch(srv, conn);
+    }
+}
+
+// Collect finished requests from the workers
+static void serve_completed(forth_server_t* srv) {
+    uint64_t count;
+    ssize_t r = read(srv->event_fd, &count, sizeof(count));
+    (void)r;
+    pthread_mutex_lock(&srv->lock);
+    serve_conn_t* conn = srv->done;
+    srv->done = NULL;
+    pthread_mutex_unlock(&srv->lock);
+    
+    while (conn) {
+        serve_conn_t* next = conn->next_job;
+        conn->busy = 0;
+        if (!conn->closed && !serve_append(conn, conn->reply, conn->reply_len)) conn->closed = 1;
+        if (!conn->closed) serve_flush(conn);
+        serve_update(srv, conn);
+        conn = next;
+    }
+}
+
+// Serve requests on path until *stop is set (e.g. from a signal
+// handler; epoll_wait returns early on signals). nthreads 0: one
+// worker per core. Returns 0 on a clean shutdown, 1 if the server
+// couldn't start (out of memory, threads or descriptors).
+static int serve_forth(const forth_t* base, const char* path, int nthreads,
+                       volatile sig_atomic_t* stop) {
+    if (nthreads <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (nthreads <= 0) nthreads = 1;
+    }
+    
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+    
+    forth_server_t* srv = calloc(1, sizeof(*srv));
+    if (!srv) return 1;
+    srv->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(path);
+    if (srv->listen_fd < 0 || bind(srv->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(srv->listen_fd, SOMAXCONN) < 0) {
+        fprintf(stderr, "Cannot listen on %s: %s\n", path, strerror(errno));
+        if (srv->listen_fd >= 0) close(srv->listen_fd);
+        free(srv);
+        return 1;
+    }
+    srv->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    srv->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &srv->listen_fd };
+    int ok = srv->epoll_fd >= 0 && srv->event_fd >= 0 &&
+             epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, srv->listen_fd, &ev) == 0;
+    ev.data.ptr = &srv->event_fd;
+    ok = ok && epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, srv->event_fd, &ev) == 0;
+    
+    // Workers capture output and diagnostics, and BYE only ends the
+    // request; PAR-DO runs sequentially inside a request, and a channel
+    // op that would wait fails it rather than holding the worker
+    int pooled = ok && init_vm_pool(&srv->vms, base, nthreads);
+    for (int i = 0; pooled && i < nthreads; i++) {
+        forth_t* vm = &srv->vms.vms[i];
+        memset(&vm->ctx.io, 0, sizeof(vm->ctx.io));
+        vm->ctx.io.putchar_fn = serve_putchar;
+        vm->ctx.io.error_fn = serve_error;
+        vm->ctx.pool = NULL;
+        vm->ctx.no_block = 1;
+        vm->no_exit = 1;
+    }
+    pthread_mutex_init(&srv->lock, NULL);
+    pthread_cond_init(&srv->ready, NULL);
+    pthread_t* threads = pooled ? malloc(sizeof(pthread_t) * (size_t)nthreads) : NULL;
+    int started = 0;
+    while (threads && started < nthreads &&
+           pthread_create(&threads[started], NULL, serve_worker, srv) == 0) {
+        started++;
+    }
+    ok = started == nthreads;
+    if (!ok) fprintf(stderr, "Cannot start the server on %s: out of resources\n", path);
+    
+    struct epoll_event events[64];
+    while (ok && !*stop) {
+        int n = epoll_wait(srv->epoll_fd, events, 64, -1);
+        for (int i = 0; i < n; i++) {
+            void* p = events[i].data.ptr;
+            if (p == &srv->listen_fd) {
+                serve_accept(srv);
+            } else if (p == &srv->event_fd) {
+                serve_completed(srv);
+            } else {
+                serve_conn_t* conn = p;
+                if (events[i].events & EPOLLIN) serve_read(conn);
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) conn->closed = 1;
+                if (events[i].events & EPOLLOUT) serve_flush(conn);
+                serve_update(srv, conn);
+            }
+        }
+    }
+    
+    pthread_mutex_lock(&srv->lock);
+    srv->stopping = 1;
+    pthread_cond_broadcast(&srv->ready);
+    pthread_mutex_unlock(&srv->lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    while (srv->conns) serve_close(srv, srv->conns);
+    if (pooled) free_vm_pool(&srv->vms);
+    pthread_cond_destroy(&srv->ready);
+    pthread_mutex_destroy(&srv->lock);
+    if (srv->event_fd >= 0) close(srv->event_fd);
+    if (srv->epoll_fd >= 0) close(srv->epoll_fd);
+    close(srv->listen_fd);
+    unlink(path);
+    free(srv);
+    return ok ? 0 : 1;
+}
+
+#endif // FORTH_SERVER_H
@@ -0,0 +1,218 @@
+// Sharded file processing: run a word over every line of a file on all
+// cores. The file is mapped, split into line-aligned shards, and each
+// worker processes shards on its own context over the shared image.
+// The current line (without its newline) is at FF_INPUT_BASE. Each
+// worker starts from a copy of the caller's USER area and heap, so
+// variables and tables set up at load time are visible to the word.
+//
+//   without reduce: WORD ( addr len -- ); output is kept in input order
+//   with reduce:    WORD ( acc addr len -- acc' ); each shard starts
+//                   from 0, shard results are folded in input order with
+//                   REDUCE ( a b -- c ) and the total is printed
+#ifndef FORTH_SHARD_H
+#define FORTH_SHARD_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "forth_fast.h"
+
+#ifndef FF_SHARDS_PER_THREAD
+#define FF_SHARDS_PER_THREAD 8  // More shards than workers evens out skew
+#endif
+
+typedef struct {
+    size_t begin, end;      // Byte range, line aligned
+    char* out;              // Captured output
+    size_t out_len, out_cap;
+    cell_t acc;
+    int failed;
+    int done;
+} forth_shard_t;
+
+typedef struct {
+    forth_image_t* img;
+    const forth_ctx_t* seed;    // USER area and heap each worker copies
+    addr_t word;
+    int reduce;
+    uint8_t* data;
+    forth_shard_t* shards;
+    int nshards;
+    _Atomic int next;       // Next shard to hand out
+    
+    // Finished shards are written out in order as soon as possible
+    pthread_mutex_t lock;
+    int flushed;
+} forth_shards_t;
+
+static _Thread_local forth_shard_t* shard_current;
+
+static void shard_putchar(int c) {
+    forth_shard_t* sh = shard_current;
+    if (sh->out_len == sh->out_cap) {
+        size_t cap = sh->out_cap ? sh->out_cap * 2 : 4096;
+        char* out = realloc(sh->out, cap);
+        if (!out) return;
+        sh->out = out;
+        sh->out_cap = cap;
+    }
+    sh->out[sh->out_len++] = (char)c;
+}
+
+static void shard_run(forth_shards_t* job, forth_ctx_t* ctx, forth_shard_t* sh) {
+    shard_current = sh;
+    ctx->sp = ctx->rp = 0;
+    if (job->reduce) PUSH(ctx, 0);
+    
+    uint8_t* p = job->data + sh->begin;
+    uint8_t* end = job->data + sh->end;
+    while (p < end) {
+        uint8_t* nl = memchr(p, '\n', (size_t)(end - p));
+        uint8_t* line_end = nl ? nl : end;
+        cell_t len = (cell_t)(line_end - p);
+        if (len > 0 && p[len - 1] == '\r') len--;
+        ctx->input = p;
+        ctx->input_len = len;
+        if (!job->reduce) ctx->sp = 0;
+        PUSH(ctx, FF_INPUT_BASE);
+        PUSH(ctx, len);
+        if (execute(job->img, ctx, job->word) != FF_OK) {
+            fprintf(stderr, "Error processing the line at byte %zu\n", (size_t)(p - job->data));
+            sh->failed = 1;
+            break;
+        }
+        p = nl ? nl + 1 : end;
+    }
+    sh->acc = job->reduce && ctx->sp > 0 ? TOS(ctx) : 0;
+    ctx->input = NULL;
+    ctx->input_len = 0;
+}
+
+static void shard_job(forth_pool_t* pool, int worker, void* arg) {
+    (void)pool;
+    (void)worker;
+    forth_shards_t* job = arg;
+    forth_ctx_t* ctx = malloc(sizeof(*ctx));
+    if (!ctx || !init_ctx(ctx) || !copy_heap(ctx, job->seed)) {
+        if (ctx) free_ctx(ctx);
+        free(ctx);
+        return;
+    }
+    memcpy(ctx->data, job->seed->data, sizeof(ctx->data));
+    memset(&ctx->io, 0, sizeof(ctx->io));
+    ctx->io.putchar_fn = shard_putchar;
+    
+    int i;
+    while ((i = atomic_fetch_add(&job->next, 1)) < job->nshards) {
+        forth_shard_t* sh = &job->shards[i];
+        shard_run(job, ctx, sh);
+        
+        pthread_mutex_lock(&job->lock);
+        sh->done = 1;
+        while (job->flushed < job->nshards && job->shards[job->flushed].done) {
+            forth_shard_t* f = &job->shards[job->flushed++];
+            if (f->out_len) fwrite(f->out, 1, f->out_len, stdout);
+            free(f->out);
+            f->out = NULL;
+        }
+        pthread_mutex_unlock(&job->lock);
+    }
+    free_ctx(ctx);
+    free(ctx);
+}
+
+// Process path with word (and reduce, if not NULL) on the pool's
+// workers, or on the calling thread without a pool. 0 on success.
+static int process_file(forth_t* vm, forth_pool_t* pool, const char* word,
+                        const char* reduce, const char* path) {
+    forth_image_t* img = &vm->image;
+    word_t* w = find_word(img, word);
+    word_t* r = reduce ? find_word(img, reduce) : NULL;
+    if (!w || (reduce && !r)) {
+        fprintf(stderr, "? %s\n", w ? reduce : word);
+        return 1;
+    }
+    
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    size_t size = (size_t)st.st_size;
+    // Private writable mapping: records may be modified in place
+    uint8_t* data = size ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (size && data == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s\n", path);
+        return 1;
+    }
+    
+    int nthreads = pool ? pool->nthreads : 1;
+    int nshards = nthreads * FF_SHARDS_PER_THREAD;
+    forth_shards_t job;
+    memset(&job, 0, sizeof(job));
+    job.img = img;
+    job.seed = &vm->ctx;
+    job.word = w->addr;
+    job.reduce = reduce != NULL;
+    job.data = data;
+    job.shards = calloc((size_t)nshards, sizeof(forth_shard_t));
+    if (!job.shards) {
+        if (data) munmap(data, size);
+        return 1;
+    }
+    
+    // Shard boundaries, each moved forward past the next newline
+    size_t pos = 0;
+    for (int i = 0; i < nshards; i++) {
+        size_t end = i == nshards - 1 ? size : size / nshards * (i + 1);
+        if (end < pos) end = pos;
+        while (end > 0 && end < size && data[end - 1] != '\n') end++;
+        job.shards[i].begin = pos;
+        job.shards[i].end = end;
+        pos = end;
+    }
+    job.nshards = nshards;
+    atomic_init(&job.next, 0);
+    pthread_mutex_init(&job.lock, NULL);
+    
+    if (pool) pool_run(pool, shard_job, &job);
+    // Workers that couldn't set up a context take no shards; if none
+    // could, try on the calling thread
+    if (atomic_load(&job.next) < nshards) shard_job(NULL, 0, &job);
+    fflush(stdout);
+    
+    int failed = 0;
+    cell_t total = 0;
+    int have_total = 0;
+    for (int i = 0; i < nshards; i++) {
+        forth_shard_t* sh = &job.shards[i];
+        failed |= sh->failed || !sh->done;
+        if (!reduce || sh->begin == sh->end) continue;
+        if (!have_total) {
+            total = sh->acc;
+            have_total = 1;
+            continue;
+        }
+        forth_ctx_t* ctx = &vm->ctx;
+        ctx->sp = 0;
+        PUSH(ctx, total);
+        PUSH(ctx, sh->acc);
+        if (execute(img, ctx, r->addr) != FF_OK) {
+            failed = 1;
+            break;
+        }
+        total = POP(ctx);
+    }
+    if (atomic_load(&job.next) < nshards) fprintf(stderr, "Out of memory processing %s\n", path);
+    if (reduce && !failed) printf("%lld\n", (long long)total);
+    
+    pthread_mutex_destroy(&job.lock);
+    free(job.shards);
+    if (data) munmap(data, size);
+    return failed;
+}
+
+#endif // FORTH_SHARD_H
@@ -0,0 +1,22 @@
+\ Bignums: cap, used length, then limbs least significant first, in
+\ any cell-aligned buffer. Results that don't fit fail with ior -11,
+\ bad buffers with -9.
+CREATE F 12 CELLS ALLOT 10 F BIG-INIT
+CREATE G 12 CELLS ALLOT 10 G BIG-INIT
+CREATE P 12 CELLS ALLOT 10 P BIG-INIT
+: FAC ( n -- ) 1 F BIG! 1+ 2 DO F I BIG*N DROP LOOP ;
+30 FAC F BIG. \ expect 265252859812191058636308480000000
+F 30 BIG/N DROP . F 29 BIG/N DROP . F BIG. \ expect 0 0 304888344611713860501504000000
+\ 2^64 by doubling, then squared into P
+1 G BIG! : DOUBLE 64 0 DO G G BIG+ DROP LOOP ; DOUBLE G BIG. \ expect 18446744073709551616
+P G G BIG* . P BIG. \ expect 0 340282366920938463463374607431768211456
+P G BIGCOMPARE . G P BIGCOMPARE . G G BIGCOMPARE . \ expect 1 -1 0
+P P P BIG* . \ expect -9: the destination overlaps a factor
+CREATE T 3 CELLS ALLOT 1 T BIG-INIT
+T P BIG+ . \ expect -11: 2^128 doesn't fit in one cell
+CREATE S 48 ALLOT
+G S 48 BIG>STR S SWAP TYPE CR \ expect 18446744073709551616
+P S 8 BIG>STR . \ expect 0: too short
+0 G BIG! G BIG. G 7 BIG/N . . \ expect 0 0 0
+G 0 BIG/N . . \ expect -10 0: division by zero
+G 1+ 7 BIG/N . . G 1+ G BIGCOMPARE . \ expect -9 0 -9: misaligned
@@ -0,0 +1,18 @@
+\ Bulk memory: MOVE, CMOVE, CMOVE>, FILL, ERASE and COMPARE work on
+\ whole ranges at once, in the dictionary or the heap
+CREATE BUF 16 ALLOT
+: SHOW ( addr u -- ) 0 DO DUP I + C@ EMIT LOOP DROP 32 EMIT ;
+BUF 16 65 FILL BUF 16 SHOW \ expect AAAAAAAAAAAAAAAA
+BUF 4 + 8 ERASE BUF 4 + C@ . BUF 12 + C@ . \ expect 0 65
+BUF 16 66 FILL BUF C@ 1+ BUF C!
+BUF BUF 1+ 7 CMOVE BUF 8 SHOW \ expect CCCCCCCC: the first byte repeats
+BUF 4 + BUF 4 MOVE BUF 8 SHOW \ expect CCCCCCCC
+BUF 16 ERASE 68 BUF 15 + C! BUF 1+ BUF 15 CMOVE> BUF 15 + C@ . \ expect 68
+BUF C@ . \ expect 68: the last byte repeats all the way down
+BUF 4 BUF 4 COMPARE . BUF 3 BUF 4 COMPARE . \ expect 0 -1
+1 BUF C! BUF 1 BUF 1+ 1 COMPARE . \ expect -1: 1 sorts before 68
+BUF -1 BUF -1 COMPARE . \ expect -1: a bad range is never equal
+\ The heap too: copy BUF out, change it, compare
+16 ALLOCATE DROP CONSTANT COPY
+BUF COPY 16 MOVE COPY 16 BUF 16 COMPARE . \ expect 0
+COPY 16 70 FILL COPY 16 BUF 16 COMPARE . \ expect 1
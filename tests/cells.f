@@ -0,0 +1,13 @@
+\ Cells and alignment: CREATE data is cell aligned, CELLS and CELL+
+\ step through it, ALIGN and ALIGNED round up to a cell boundary
+CREATE TABLE 10 CELLS ALLOT
+: FILL-TABLE ( -- ) 10 0 DO I I * TABLE I CELLS + ! LOOP ;
+: SUM-TABLE ( -- n ) 0 10 0 DO TABLE I CELLS + @ + LOOP ;
+FILL-TABLE SUM-TABLE . \ expect 285
+TABLE DUP ALIGNED - . \ expect 0: TABLE is aligned
+TABLE CELL+ @ . TABLE 3 CELLS + @ . \ expect 1 9
+5 ALIGNED . 8 ALIGNED . \ expect 8 8
+1 ALLOT ALIGN HERE DUP ALIGNED = . \ expect -1
+\ Unaligned cells still work, one byte at a time
+HERE 9 ALLOT 1+ CONSTANT ODD
+12345 ODD ! ODD @ . \ expect 12345
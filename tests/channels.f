@@ -0,0 +1,21 @@
+\ Channels: bounded FIFO queues of cells, shared by tasks, VMs and
+\ threads. n CHANNEL name makes one of at least n slots (rounded up to
+\ a power of two) and a word pushing its number.
+4 CHANNEL Q
+1 Q SEND 2 Q SEND 3 Q SEND
+Q RECV . Q RECV . Q RECV . \ expect 1 2 3: first in, first out
+Q TRY-RECV . \ expect 0: empty, nothing else pushed
+7 Q SEND Q TRY-RECV . . \ expect -1 7
+99 TRY-RECV . \ expect 0: not a channel
+CR
+
+\ A SEND on a full channel or a RECV on an empty one leaves its
+\ operands and switches to the next task until it can go on
+2 CHANNEL PIPE
+VARIABLE TOTAL
+: PRODUCER  10 0 DO I PIPE SEND LOOP  -1 PIPE SEND  BEGIN PAUSE AGAIN ;
+TASK P
+' PRODUCER P ACTIVATE
+: CONSUME  ( -- ) BEGIN PIPE RECV DUP 0< 0= WHILE TOTAL +! REPEAT DROP ;
+CONSUME TOTAL @ . \ expect 45: every value, though only two fit at once
+CR
@@ -0,0 +1,8 @@
+\ Double cells: ( lo hi ) with the high cell on top. Mixed products
+\ keep every bit; UM/MOD and SM/REM divide them back down.
+-3 4 M* D. \ expect -12
+100000 100000 M* D. \ expect 10000000000
+100000 100000 UM* 7 UM/MOD . . \ expect 1428571428 4
+-7 1 M* 2 SM/REM . . \ expect -3 -1: rounds toward zero
+1 0 -1 -1 D+ D. \ expect 0
+0 1 1 0 D- D. 0 1 D. \ expect 4294967295 4294967296 (32-bit cells)
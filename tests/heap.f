@@ -0,0 +1,21 @@
+\ Heap: ALLOCATE, FREE and RESIZE return an ior, 0 on success. Blocks
+\ live outside the dictionary, so temporary buffers don't use it up.
+VARIABLE BUF
+: SQUARES ( n -- ) 0 DO I I * BUF @ I CELLS + ! LOOP ;
+: SUM ( n -- sum ) 0 SWAP 0 DO BUF @ I CELLS + @ + LOOP ;
+HERE
+10 CELLS ALLOCATE . BUF ! \ expect 0
+10 SQUARES 10 SUM . \ expect 285
+BUF @ 1000 CELLS RESIZE . BUF ! \ expect 0: a large block now
+10 SUM . \ expect 285, the contents moved with it
+1000 SQUARES 1000 SUM . \ expect 332833500
+BUF @ FREE . \ expect 0
+BUF @ FREE . \ expect -60: already freed
+16 ALLOCATE . 16 ALLOCATE . - ABS . \ expect 0 0 32: one size class
+-1 ALLOCATE . . \ expect -59 0
+HERE = . \ expect -1: the dictionary did not grow
+VARIABLE A  VARIABLE B
+64 ALLOCATE DROP A !  64 ALLOCATE DROP B !
+A @ FREE DROP  B @ 16777216 - A @ ! \ overwrite the free-list link with B
+64 ALLOCATE DROP A @ = . \ expect -1
+64 ALLOCATE DROP B @ = . \ expect 0: B is live, the list is dropped
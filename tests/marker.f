@@ -0,0 +1,24 @@
+\ MARKER and FORGET: discard scratch definitions and reclaim their space
+: SQUARE ( n -- n*n ) DUP * ;
+HERE
+MARKER SCRATCH
+VARIABLE TMP
+USER SLOT
+: CUBE ( n -- n^3 ) DUP SQUARE * ;
+3 CUBE . \ expect 27
+SCRATCH \ forget TMP, SLOT, CUBE and SCRATCH itself
+HERE = . \ expect -1: all of their space is back
+USER SLOT2 SLOT2 . \ expect 65536: the USER cell is reused
+: HELPER 10 + ;
+: TWICE ( n -- n' ) HELPER HELPER ;
+5 TWICE . \ expect 25
+FORGET HELPER \ forgets TWICE too
+: HELPER 100 + ;
+5 HELPER . \ expect 105
+4 SQUARE . \ expect 16
+USER U1  U1 CONSTANT C
+FORGET C USER U2
+U2 U1 - 1 CELLS = . \ expect -1: a CONSTANT holding a USER address owns no cell
+1 CHANNEL CH1
+FORGET CH1 1 CHANNEL CH2
+CH2 . \ expect 1: FORGET gives the channel back
@@ -0,0 +1,4 @@
+\ Library file for modules.f
+VARIABLE CALLS
+: SQUARE  ( n -- n*n ) 1 CALLS +! DUP * ;
+: CUBE    ( n -- n^3 ) DUP SQUARE * ;
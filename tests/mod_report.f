@@ -0,0 +1,5 @@
+\ Library file for modules.f: SQUARE and CALLS come from mod_math.f,
+\ which is compiled at the same time and linked first
+: SUMSQ   ( n -- sum ) 0 SWAP 0 DO I SQUARE + LOOP ;
+: REPORT  ( n -- ) ." sum of squares: " SUMSQ . ." calls: " CALLS @ . CR ;
+VARIABLE HITS   \ Data in a later file, moved when linked
@@ -0,0 +1,6 @@
+\ Independent files compiled in parallel, then linked in order
+LOAD-PAR tests/mod_math.f tests/mod_report.f
+3 CUBE . \ expect 27
+10 REPORT \ expect sum of squares: 285 calls: 11
+HITS DUP ALIGNED = . \ expect -1: moved by whole cells
+5 HITS ATOMIC! HITS ATOMIC@ . \ expect 5
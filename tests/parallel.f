@@ -0,0 +1,31 @@
+\ Parallel DO loops with a declared reduction
+\ ( acc limit index ) PAR-DO body PAR-LOOP <op>, op is + MAX MIN AND OR
+\ The body is ( acc -- acc' ); each worker starts from the identity of op
+
+: SUM   ( n -- sum ) 0 SWAP 0 DO I + LOOP ;
+: PSUM  ( n -- sum ) 0 SWAP 0 PAR-DO I + PAR-LOOP + ;
+: PMAX  ( n -- max ) 0 SWAP 0 PAR-DO I 1000 MOD MAX PAR-LOOP MAX ;
+
+100000 SUM . 100000 PSUM . \ expect the same twice
+50000 PMAX . \ expect 999
+CR
+
+\ Shared counters need the atomic words: +! from several workers races
+VARIABLE HITS
+: COUNT-HITS  ( n -- ) 0 SWAP 0 PAR-DO 1 HITS ATOMIC+! PAR-LOOP + DROP ;
+0 HITS ATOMIC!
+100000 COUNT-HITS
+HITS ATOMIC@ . \ expect 100000
+5 HITS ATOMIC! 5 9 HITS CAS . HITS @ . \ expect -1 9
+5 7 HITS CAS . \ expect 0
+CR
+
+\ The body sees the caller's USER area and heap, but can't ALLOCATE
+USER SCALE 7 SCALE !
+2000 CELLS ALLOCATE DROP CONSTANT ONES
+: FILL-ONES 2000 0 DO 1 ONES I CELLS + ! LOOP ;
+: PHEAP ( -- sum ) 0 2000 0 PAR-DO ONES I CELLS + @ + PAR-LOOP + ;
+: PUSER ( -- sum ) 0 2000 0 PAR-DO SCALE @ + PAR-LOOP + ;
+: PALLOC ( -- n ) 0 2000 0 PAR-DO 8 ALLOCATE NIP 0<> - PAR-LOOP + ;
+FILL-ONES PHEAP . PUSER . PALLOC . \ expect 2000 14000 2000
+CR
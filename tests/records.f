@@ -0,0 +1,18 @@
+\ Per-line words for sharded file processing (forth_fast -p)
+\ The current line is at addr len; run this file over itself:
+\   forth_fast -q -j 4 -p ECHO tests/records.f tests/records.f
+\   forth_fast -q -j 4 -p CHARS -r + tests/records.f tests/records.f
+\   forth_fast -q -j 4 -p LONGEST -r MAX tests/records.f tests/records.f
+\   forth_fast -q -j 4 -p BLANKS -r + tests/records.f tests/records.f
+
+: ECHO     ( addr len -- ) TYPE CR ;
+: CHARS    ( acc addr len -- acc' ) NIP + ;
+: LONGEST  ( acc addr len -- acc' ) NIP MAX ;
+
+\ Load-time state is visible to every worker: a USER weight and a table
+\ built with ALLOCATE
+USER WEIGHT   1 WEIGHT !
+256 ALLOCATE DROP CONSTANT CLASS
+CLASS 256 ERASE   1 CLASS 32 + C!
+: BLANKS   ( acc addr len -- acc' )
+    ?DUP IF 0 DO DUP I + C@ CLASS + C@ WEIGHT @ * ROT + SWAP LOOP THEN DROP ;
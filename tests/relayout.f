@@ -0,0 +1,20 @@
+\ Profile-driven relayout: PROFILE counts calls, RELAYOUT packs the hot
+\ words together and moves cold words and ." strings out of line
+: STEP ( n -- n' ) DUP 1 AND IF 3 * 1+ ELSE 2 / THEN ;
+: USAGE ." usage: n RUN prints the checksum of a Collatz walk from n" CR ;
+VARIABLE TOTAL
+HERE 100 ALLOT CONSTANT SCRATCH
+: ABOUT ." Walks are capped at 100 steps; the checksum is the sum of" CR
+        ." every value visited, so equal walks give equal sums" CR ;
+: ADDUP ( n -- ) TOTAL +! ;
+: OOPS ." something went wrong, please report it with the input" CR ;
+: REPORT ." total: " TOTAL @ . CR ;
+: RUN ( n -- ) 0 TOTAL ! 100 0 DO STEP DUP ADDUP LOOP DROP REPORT ;
+: RUNNER ' RUN ; \ keeps RUN in place: its xt is a literal
+42 SCRATCH !
+PROFILE
+27 RUN \ expect total: 101067
+RELAYOUT
+27 RUN \ expect total: 101067
+SCRATCH @ . \ expect 42
+USAGE
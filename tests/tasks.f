@@ -0,0 +1,16 @@
+\ Cooperative multitasking demo
+\ Each TASK has its own stacks; PAUSE switches round-robin
+
+VARIABLE TICKS
+: COUNTER  BEGIN 1 TICKS +! PAUSE AGAIN ;
+: HELLO  ." [hello from a task] " ;
+
+TASK T1
+TASK T2
+' COUNTER T1 ACTIVATE
+' HELLO T2 ACTIVATE
+
+: RUN  ( n -- ) 0 DO PAUSE LOOP ;
+10 RUN
+TICKS @ . \ expect 10
+CR